@@ -60,11 +60,15 @@ extern uint8_t Crc8CCITT(uint8_t ui8Crc, const uint8_t *pui8Data,
                          uint32_t ui32Count);
 extern uint16_t Crc16(uint16_t ui16Crc, const uint8_t *pui8Data,
                       uint32_t ui32Count);
+extern uint16_t Crc16Slice4(uint16_t ui16Crc, const uint8_t *pui8Data,
+                            uint32_t ui32Count);
 extern uint16_t Crc16Array(uint32_t ui32WordLen, const uint32_t *pui32Data);
 extern void Crc16Array3(uint32_t ui32WordLen, const uint32_t *pui32Data,
                         uint16_t *pui16Crc3);
 extern uint32_t Crc32(uint32_t ui32Crc, const uint8_t *pui8Data,
                       uint32_t ui32Count);
+extern uint32_t Crc32Slice4(uint32_t ui32Crc, const uint8_t *pui8Data,
+                            uint32_t ui32Count);
 
 //*****************************************************************************
 //
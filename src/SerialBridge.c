@@ -7,7 +7,7 @@
  *
  * CREATED:	    04/13/2019
  *
- * LAST EDITED:	    04/23/2021
+ * LAST EDITED:	    10/19/2026
  ***/
 
 /******************************************************************************
@@ -16,18 +16,567 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
+#include "inc/hw_gpio.h"
+#include "inc/hw_ints.h"
 #include "inc/hw_memmap.h"
+#include "inc/hw_nvic.h"
+#include "inc/hw_sysctl.h"
+#include "inc/hw_types.h"
+#include "inc/hw_uart.h"
 #include "driverlib/gpio.h"
 #include "driverlib/pin_map.h"
 #include "driverlib/rom.h"
 #include "driverlib/sysctl.h"
+#include "driverlib/systick.h"
+#include "driverlib/timer.h"
 #include "driverlib/uart.h"
 #include "driverlib/interrupt.h"
+#include "arq.h"
+#include "boot.h"
+#include "crash.h"
+#include "cycles.h"
+#include "frame.h"
+#include "lz.h"
+#include "markers.h"
+#include "ports.h"
+#include "prbs.h"
+#include "ringbuf.h"
+#include "sram.h"
+#include "tap.h"
+#include "timebase.h"
+#include "trace.h"
 
 #ifndef CONFIG_UART_BAUDRATE
 #define CONFIG_UART_BAUDRATE 115200
 #endif
 
+// Whether ports echo received chars back to the sender at boot. This only sets
+// the initial value of each port's `echo' flag, which can be changed at
+// runtime.
+#ifdef CONFIG_UART_ECHO
+#define UART_ECHO_DEFAULT true
+#else
+#define UART_ECHO_DEFAULT false
+#endif
+
+// Size of each of the per-port software queues. Must be a power of two.
+#ifndef CONFIG_UART_RING_SIZE
+#define CONFIG_UART_RING_SIZE 1024
+#endif
+_Static_assert((CONFIG_UART_RING_SIZE & (CONFIG_UART_RING_SIZE - 1)) == 0,
+  "CONFIG_UART_RING_SIZE must be a power of two");
+
+// Interrupt priorities. The TM4C only implements the upper three bits, which
+// are split into two bits of preemption priority (the group) and one of
+// subpriority. Interrupts in one group never preempt each other, and when
+// several are pending, the lowest subpriority is taken first. The UART top
+// halves and the ports' timers share the highest group, so a burst on one
+// port can hold off draining the other port's RX FIFO by at most one top
+// half, and no top half is ever nested in another. Ties go to UART1: the
+// target's output is the bulk of the traffic, and nothing can send it again
+// if its RX FIFO overruns. The bottom half runs in PendSV in the lowest
+// group, so it is preempted by any top half.
+#define INT_PRIORITY_GROUP_BITS 2
+#define INT_PRIORITY(group, sub) (((group) << (8 - INT_PRIORITY_GROUP_BITS)) \
+    | ((sub) << 5))
+#define UART0_INT_PRIORITY  INT_PRIORITY(0, 1)
+#define UART1_INT_PRIORITY  INT_PRIORITY(0, 0)
+#define TIMER_INT_PRIORITY  INT_PRIORITY(0, 1)
+#define PENDSV_INT_PRIORITY INT_PRIORITY(3, 1)
+
+// Clock gating and peripheral ready registers, which driverlib keeps to
+// itself. A SYSCTL_PERIPH_* value holds the offset of its register and its
+// bit in either one.
+#define SYSCTL_RCGCBASE     0x400fe600
+#define SYSCTL_PRBASE       0x400fea00
+#define PERIPH_REG(periph)  (((periph) & 0xff00) >> 8)
+#define PERIPH_BIT(periph)  ((periph) & 0xff)
+
+// SW1 on the LaunchPad. Held down at reset, it asks for the crash record.
+#define REPORT_BUTTON_PERIPH SYSCTL_PERIPH_GPIOF
+#define REPORT_BUTTON_BASE   GPIO_PORTF_BASE
+#define REPORT_BUTTON_PIN    GPIO_PIN_4
+
+// The crash record is sent to the host as text, in frames on a framed link.
+// The ARQ would take a frame outside its sequence for a lost one, and the
+// host would decode text on a compressed link as LZ, so those builds (and
+// the bit-error-rate tester, which has the ports to itself) leave the
+// record for the debugger.
+#if !defined(CONFIG_UART_BERT) && !defined(CONFIG_UART_ARQ) \
+  && !defined(CONFIG_UART_COMPRESS)
+#define CRASH_REPORT
+// Chars of the report sent at a time, as one frame on a framed link.
+#define REPORT_CHUNK 64
+#endif
+
+// Line conditions. These are only looked at when the UART flags one of them,
+// so they cost nothing per character.
+#define UART_LINE_ERROR_INTS (UART_INT_OE | UART_INT_BE | UART_INT_PE \
+    | UART_INT_FE)
+
+// A forwarded break is held for at least this many character times, which is
+// the minimum the TM4C (and most other UARTs) need to detect one.
+#define BREAK_MIN_CHARS 2
+
+#ifdef CONFIG_UART_COALESCE
+// Defaults for the per-port coalescing settings. Held chars are released when
+// the delimiter arrives, when this many are held, when nothing has arrived
+// for the inter-byte timeout, or when the oldest has been held for the
+// maximum latency.
+#ifndef CONFIG_UART_COALESCE_DELIMITER
+#define CONFIG_UART_COALESCE_DELIMITER '\n'
+#endif
+#ifndef CONFIG_UART_COALESCE_SIZE
+#define CONFIG_UART_COALESCE_SIZE 256
+#endif
+#ifndef CONFIG_UART_COALESCE_TIMEOUT_US
+#define CONFIG_UART_COALESCE_TIMEOUT_US 2000
+#endif
+#ifndef CONFIG_UART_COALESCE_MAX_US
+#define CONFIG_UART_COALESCE_MAX_US 20000
+#endif
+_Static_assert(CONFIG_UART_COALESCE_SIZE <= CONFIG_UART_RING_SIZE,
+  "CONFIG_UART_COALESCE_SIZE must fit in the rx queue");
+
+// Coalescing settings and state of a port. The settings may be changed at
+// runtime with a debugger. `released' and `scanned' count chars from the
+// start of the rx queue that may be forwarded and that have been searched
+// for the delimiter, respectively.
+typedef struct {
+
+  volatile bool enabled;
+  uint8_t delimiter;
+  uint32_t size;
+  uint32_t timeoutUs;
+  uint32_t maxUs;
+
+  uint32_t cyclesPerUs;
+  volatile bool timedOut;
+  uint32_t released;
+  uint32_t scanned;
+  uint32_t armedCount;
+  uint32_t heldSince;
+  uint32_t flushes;
+
+} coalesce_t;
+#endif
+
+// A general purpose timer (timer A, in 32-bit mode) owned by a port.
+typedef struct {
+
+  uint32_t periph;
+  uint32_t base;
+  uint32_t intNum;
+  void (*handler)(void);
+
+} hwtimer_t;
+
+#if defined(CONFIG_UART_POLL) && defined(CONFIG_UART_HYBRID)
+#error "CONFIG_UART_POLL and CONFIG_UART_HYBRID are mutually exclusive"
+#endif
+
+#ifdef CONFIG_UART_GAP
+#if defined(CONFIG_UART_POLL) || defined(CONFIG_UART_HYBRID) \
+  || defined(CONFIG_UART_COALESCE)
+#error "CONFIG_UART_GAP can't be combined with POLL, HYBRID or COALESCE"
+#endif
+// Chars are replayed straight from the rx queue, and never reach the
+// compressor in the bottom half.
+#ifdef CONFIG_UART_COMPRESS
+#error "CONFIG_UART_GAP and CONFIG_UART_COMPRESS are mutually exclusive"
+#endif
+// Depth of the rx queue in gap mode, which is also the number of timestamps
+// kept per port. One Modbus RTU frame is at most 256 bytes.
+#ifndef CONFIG_UART_GAP_DEPTH
+#define CONFIG_UART_GAP_DEPTH 256
+#endif
+_Static_assert((CONFIG_UART_GAP_DEPTH & (CONFIG_UART_GAP_DEPTH - 1)) == 0
+  && CONFIG_UART_GAP_DEPTH <= CONFIG_UART_RING_SIZE,
+  "CONFIG_UART_GAP_DEPTH must be a power of two, at most the ring size");
+// Default replay delay, and the silence that separates two frames, in bit
+// times. 35 bit times is the 3.5 character times of Modbus RTU.
+#ifndef CONFIG_UART_GAP_DELAY_BITS
+#define CONFIG_UART_GAP_DELAY_BITS 10
+#endif
+#ifndef CONFIG_UART_GAP_FRAME_BITS
+#define CONFIG_UART_GAP_FRAME_BITS 35
+#endif
+
+// Gap-preserving state of a port. Every received char is stamped with the
+// timebase, and is sent on the other port exactly `delay' cycles later, so
+// the gaps between chars are reproduced. `delay' may be changed at runtime.
+// `late' is the worst amount by which a char missed its slot, and `frames'
+// counts gaps of at least `frameGap' cycles.
+typedef struct {
+
+  volatile uint32_t delay;
+  uint32_t frameGap;
+  uint32_t lastStamp;
+  uint32_t frames;
+  uint32_t late;
+  uint32_t stamps[CONFIG_UART_GAP_DEPTH];
+
+} gap_t;
+#endif
+
+#ifdef CONFIG_UART_HYBRID
+// A top half run that moves at least this many chars counts as a burst. The
+// default is the RX FIFO trigger level, i.e. the interrupt wasn't a timeout.
+#ifndef CONFIG_UART_HYBRID_BURST
+#define CONFIG_UART_HYBRID_BURST 12
+#endif
+// Consecutive bursts on one port before switching to polling
+#ifndef CONFIG_UART_HYBRID_RUNS
+#define CONFIG_UART_HYBRID_RUNS 8
+#endif
+// Character times without traffic before switching back to interrupts
+#ifndef CONFIG_UART_HYBRID_IDLE_CHARS
+#define CONFIG_UART_HYBRID_IDLE_CHARS 64
+#endif
+
+typedef struct {
+
+  uint32_t pollEntries;
+  uint32_t pollExits;
+
+} hybrid_stats_t;
+#endif
+
+#ifdef CONFIG_UART_RS485
+// Half-duplex state of a port. The driver is enabled while `driving' is set,
+// and everything received meanwhile is our own transmission coming back.
+// `releaseMax' is the most cycles spent in the top half between its entry and
+// releasing the driver after the last stop bit. `replyLast' and `replyMax' are
+// the cycles from releasing the driver until the first char of the answer is
+// seen by the firmware.
+typedef struct {
+
+  volatile bool driving;
+  bool awaitingReply;
+  uint32_t releasedAt;
+  uint32_t transmissions;
+  uint32_t selfEcho;
+  uint32_t releaseMax;
+  uint32_t replyLast;
+  uint32_t replyMax;
+
+} rs485_t;
+#endif
+
+#ifdef CONFIG_UART_MULTIDROP
+// In the stream from the host, this char introduces an address: it is
+// followed either by the address to send, or by a second escape for a
+// literal 0xff.
+#define MULTIDROP_ESCAPE 0xff
+// Address (and mask) matched by the receiver on the multidrop bus. Only
+// frames sent to a matching address reach the RX FIFO.
+#ifndef CONFIG_UART_MULTIDROP_ADDR
+#define CONFIG_UART_MULTIDROP_ADDR 0x00
+#endif
+#ifndef CONFIG_UART_MULTIDROP_MASK
+#define CONFIG_UART_MULTIDROP_MASK 0xff
+#endif
+
+// Transmit state of a multidrop port. While `sending' is set, an address char
+// is on the line, and `lcrh' is the line control to restore after it.
+typedef struct {
+
+  bool sending;
+  uint32_t lcrh;
+  uint32_t addresses;
+
+} multidrop_t;
+#endif
+
+#ifdef CONFIG_UART_COMPRESS
+// Most chars compressed in one step of the bottom half. The output is staged
+// in a buffer of LZ_BOUND() of this.
+#define COMPRESS_CHUNK 256
+#endif
+
+#if defined(CONFIG_UART_FRAMED) && defined(CONFIG_UART_COMPRESS)
+#error "CONFIG_UART_FRAMED and CONFIG_UART_COMPRESS are mutually exclusive"
+#endif
+// Gap mode replays chars without going through FrameEncode.
+#if defined(CONFIG_UART_FRAMED) && defined(CONFIG_UART_GAP)
+#error "CONFIG_UART_FRAMED and CONFIG_UART_GAP are mutually exclusive"
+#endif
+
+#ifdef CONFIG_UART_ARQ
+#ifndef CONFIG_UART_FRAMED
+#error "CONFIG_UART_ARQ requires CONFIG_UART_FRAMED"
+#endif
+#ifdef CONFIG_UART_COALESCE
+#error "CONFIG_UART_ARQ and CONFIG_UART_COALESCE are mutually exclusive"
+#endif
+// The sender and the acks run in MoveRx, which gap mode never reaches.
+#ifdef CONFIG_UART_GAP
+#error "CONFIG_UART_ARQ and CONFIG_UART_GAP are mutually exclusive"
+#endif
+// Allowance for the host's turnaround in the retransmission timeout, on top
+// of the time to send a window each way.
+#ifndef CONFIG_UART_ARQ_LATENCY_US
+#define CONFIG_UART_ARQ_LATENCY_US 20000
+#endif
+// Rate at which the retransmission timeouts are checked.
+#define ARQ_TICK_HZ 1000
+#endif
+
+#ifdef CONFIG_UART_TAP
+#ifdef CONFIG_UART_GAP
+#error "CONFIG_UART_TAP and CONFIG_UART_GAP are mutually exclusive"
+#endif
+// The tap carries both directions, plus a header per run, so it needs at
+// least three times the baud rate of the bridge to keep up with both
+// directions at full rate.
+#ifndef CONFIG_UART_TAP_BAUDRATE
+#define CONFIG_UART_TAP_BAUDRATE 6000000
+#endif
+// Size of the queue of records waiting for the tap UART. Must be a power of
+// two.
+#ifndef CONFIG_UART_TAP_RING_SIZE
+#define CONFIG_UART_TAP_RING_SIZE 2048
+#endif
+// Runs read by a top half that the bottom half hasn't captured yet. Must be a
+// power of two.
+#define TAP_MARKS 16
+// The tap's interrupt may be held off by the top halves, but not by the
+// bottom half.
+#define TAP_INT_PRIORITY INT_PRIORITY(1, 0)
+
+// The end of a run read from the RX FIFO by a top half, and when it was read.
+typedef struct {
+
+  uint32_t stamp;
+  uint32_t head;
+
+} tap_mark_t;
+
+#ifdef CONFIG_UART_PRIORITY
+// A priority char, which skips the rx queue, and when it was read.
+typedef struct {
+
+  uint32_t stamp;
+  uint8_t c;
+
+} tap_priority_t;
+#endif
+
+// Runs of a port waiting to be captured. `marks' is filled by the top half
+// and emptied by the bottom half. Chars in the rx queue up to `position'
+// have been captured, and only those may be forwarded.
+typedef struct {
+
+  tap_mark_t marks[TAP_MARKS];
+  volatile uint32_t markHead;
+  volatile uint32_t markTail;
+  uint32_t lastHead;
+  uint32_t position;
+  uint32_t lateMarks;
+#ifdef CONFIG_UART_PRIORITY
+  // Priority chars waiting to be captured, filled and emptied like `marks'.
+  tap_priority_t priority[TAP_MARKS];
+  volatile uint32_t priorityHead;
+  volatile uint32_t priorityTail;
+  uint32_t latePriority;
+#endif
+
+} tap_t;
+
+// The tap's output queue and statistics.
+typedef struct {
+
+  ringbuf_t ring;
+  uint32_t epoch;
+  bool epochSent;
+  uint32_t records;
+  uint32_t bytes;
+  uint32_t dropped;
+  uint8_t storage[CONFIG_UART_TAP_RING_SIZE];
+
+} tapout_t;
+#endif
+
+#ifdef CONFIG_UART_BERT
+// The tester takes the UARTs over from the polling loop's point of view too,
+// and a multidrop port only receives what's addressed to it.
+#if defined(CONFIG_UART_POLL) || defined(CONFIG_UART_HYBRID) \
+  || defined(CONFIG_UART_MULTIDROP)
+#error "CONFIG_UART_BERT can't be combined with POLL, HYBRID or MULTIDROP"
+#endif
+// Pattern selected at boot: 7, 15 or 31.
+#ifndef CONFIG_UART_BERT_PATTERN
+#define CONFIG_UART_BERT_PATTERN 31
+#endif
+
+// Commands for the tester, written to `command' with a debugger.
+#define BERT_START 1
+#define BERT_STOP  2
+
+// Settings, state and statistics of the bit-error-rate tester. The settings
+// are read when the test is started.
+typedef struct {
+
+  // 7, 15 or 31.
+  uint32_t pattern;
+  // Ports (0 for UART0, 1 for UART1) to send and check the pattern on. With
+  // loopback, the pattern is looped back inside txPort, and rxPort is
+  // ignored.
+  uint32_t txPort;
+  uint32_t rxPort;
+  bool loopback;
+  // Baud rate of the ports under test, or 0 to keep the bridge's.
+  uint32_t baudRate;
+  volatile uint32_t command;
+  volatile bool running;
+
+  prbs_t generator;
+  prbs_checker_t checker;
+  uint64_t charsSent;
+  uint32_t framingErrors;
+  uint32_t overruns;
+  uint32_t breaks;
+
+} bert_t;
+#endif
+
+#ifdef CONFIG_UART_BENCH
+// The benchmark measures the interrupts, and its traffic has to come back
+// through the UART it left, as plain data.
+#if defined(CONFIG_UART_POLL) || defined(CONFIG_UART_HYBRID)
+#error "CONFIG_UART_BENCH can't be combined with POLL or HYBRID"
+#endif
+#if defined(CONFIG_UART_RS485) || defined(CONFIG_UART_MULTIDROP)
+#error "CONFIG_UART_BENCH can't be combined with RS485 or MULTIDROP"
+#endif
+#if defined(CONFIG_UART_FRAMED) || defined(CONFIG_UART_COMPRESS)
+#error "CONFIG_UART_BENCH can't be combined with FRAMED or COMPRESS"
+#endif
+// Length of the measurement.
+#ifndef CONFIG_UART_BENCH_MS
+#define CONFIG_UART_BENCH_MS 100
+#endif
+// Chars queued on each port to start the benchmark. They circulate from one
+// port to the other for the whole run, and must fit in the rx queues.
+#ifdef CONFIG_UART_GAP
+#define BENCH_BURST (CONFIG_UART_GAP_DEPTH / 4)
+#else
+#define BENCH_BURST (CONFIG_UART_RING_SIZE / 4)
+#endif
+// A pass of the idle loop takes a few cycles. Any longer gap between passes
+// was spent in an interrupt.
+#define BENCH_IDLE_GAP 20
+// An interrupt the bridge doesn't use, borrowed to time the exception entry
+// and exit at the UARTs' priority. The best of BENCH_PROBE_RUNS is kept, so
+// that a UART interrupt taken in the middle of one doesn't count.
+#define BENCH_PROBE_INT INT_UART2
+#define BENCH_PROBE_RUNS 16
+
+// Results of the boot-time benchmark. `bytes' counts chars forwarded in both
+// directions together, so at full line rate, bytesPerSecond is twice
+// baudRate / 10. Cycles per byte are in hundredths of a cycle.
+typedef struct {
+
+  uint32_t clockHz;
+  uint32_t baudRate;
+  uint32_t cycles;
+  uint32_t bytes;
+  uint32_t bytesPerSecond;
+  // Cycles spent in the UART top halves, and in all interrupts together.
+  uint32_t topHalfCycles;
+  uint32_t busyCycles;
+  uint32_t topHalfCyclesPer100Bytes;
+  uint32_t busyCyclesPer100Bytes;
+  // Should both be zero.
+  uint32_t dropped;
+  uint32_t overruns;
+  // Cycles from pending an interrupt to the first instruction of its
+  // handler, and from the last one back to the interrupted code, without
+  // the cost of reading the cycle counter. `entryFpCycles' is the entry
+  // when the interrupted code has used the FPU.
+  uint32_t entryCycles;
+  uint32_t exitCycles;
+  uint32_t entryFpCycles;
+  bool done;
+
+} bench_t;
+#endif
+
+#ifdef CONFIG_UART_PRIORITY
+// Chars received on the upstream port that skip the forwarding queues.
+// Default: Ctrl-C, Ctrl-Z.
+#ifndef CONFIG_UART_PRIORITY_CHARS
+#define CONFIG_UART_PRIORITY_CHARS 0x03, 0x1a
+#endif
+// Depth of the per-port queue for priority chars that find the TX FIFO full.
+#define PRIORITY_RING_SIZE 16
+#endif
+
+typedef struct {
+
+  uint32_t rxBytes;
+  uint32_t txBytes;
+  uint32_t rxDropped;
+  uint32_t echoBytes;
+  uint32_t framingErrors;
+  uint32_t parityErrors;
+  uint32_t overruns;
+  uint32_t breaks;
+#ifdef CONFIG_UART_PRIORITY
+  uint32_t priorityChars;
+  uint32_t priorityMaxBypass;
+#endif
+
+} port_stats_t;
+
+// Runtime state of a port. `rx' is filled by the port's top half and drained
+// by the bottom half. `tx' is filled by the bottom half and drained into the
+// TX FIFO by the port's top half. `echo' is the loopback stream: a copy of
+// `rx' made by the bottom half when `echo' is set, drained alongside `tx'.
+// `prio' holds priority chars from the other port's top half that didn't fit
+// in the TX FIFO, and is drained before both.
+typedef struct {
+
+  ringbuf_t rx;
+  ringbuf_t tx;
+  ringbuf_t echo;
+  volatile bool echoEnabled;
+  volatile uint32_t breakTicks;
+#ifdef CONFIG_UART_COALESCE
+  coalesce_t coalesce;
+#endif
+#ifdef CONFIG_UART_GAP
+  gap_t gap;
+#endif
+#ifdef CONFIG_UART_RS485
+  rs485_t rs485;
+#endif
+#ifdef CONFIG_UART_MULTIDROP
+  multidrop_t multidrop;
+#endif
+#if defined(CONFIG_UART_RS485) || defined(CONFIG_UART_MULTIDROP)
+  // The TX interrupt is in end-of-transmission mode.
+  bool txEot;
+#endif
+#ifdef CONFIG_UART_TAP
+  tap_t tap;
+#endif
+  port_stats_t stats;
+#ifdef CONFIG_UART_HYBRID
+  uint32_t burstRuns;
+#endif
+#ifdef CONFIG_UART_PRIORITY
+  ringbuf_t prio;
+  uint32_t priorityMap[256 / 32];
+  uint8_t prioStorage[PRIORITY_RING_SIZE];
+#endif
+  uint8_t rxStorage[CONFIG_UART_RING_SIZE];
+  uint8_t txStorage[CONFIG_UART_RING_SIZE];
+  uint8_t echoStorage[CONFIG_UART_RING_SIZE];
+
+} port_t;
+
 typedef struct {
 
   uint32_t hostGpio;
@@ -36,103 +585,2136 @@ typedef struct {
   uint32_t txPin;
   uint32_t gpioBase;
   uint32_t gpioPins;
+  uint32_t rxGpioPin;
   uint32_t uartBase;
   uint32_t baudRate;
   uint32_t config;
   void (*intHandler)(void);
+  uint32_t intNum;
+  uint32_t intPriority;
   uint32_t intMask;
+  hwtimer_t breakTimer;
+#ifdef CONFIG_UART_COALESCE
+  hwtimer_t coalesceTimer;
+#endif
+#ifdef CONFIG_UART_GAP
+  hwtimer_t gapTimer;
+#endif
+#ifdef CONFIG_UART_RS485
+  // Driver-enable pin of a half-duplex port, accessed through the AHB
+  // aperture of its GPIO port (deAhbPort is its SYSCTL_GPIOHBCTL bit).
+  bool halfDuplex;
+  uint32_t dePeriph;
+  uint32_t deAhbPort;
+  uint32_t deGpioBase;
+  uint32_t dePin;
+#endif
+#ifdef CONFIG_UART_MULTIDROP
+  bool multidrop;
+#endif
+#ifdef CONFIG_UART_COMPRESS
+  // Compressor for chars received on this UART, or NULL.
+  lz_t* compressor;
+#endif
+#ifdef CONFIG_UART_FRAMED
+  // Framed link carried by this UART, or NULL.
+  framelink_t* link;
+#endif
+#ifdef CONFIG_UART_ARQ
+  // ARQ over `link', or NULL.
+  arq_t* arq;
+#endif
+#ifdef CONFIG_UART_TRACE
+  // TRACE_UART0, TRACE_UART1 or TRACE_TAP.
+  uint8_t traceSource;
+#endif
+  bool upstream;
+  port_t* port;
+
+} uart_t;
+
+BRIDGE_PORTS(PORT_DECLARE_HANDLERS)
+void ArqTimerHandler(void);
+void TapUARTHandler(void);
+void BenchProbeHandler(void);
+void PendSVHandler(void);
+
+// The forwarding queues.
+static port_t port0 SRAM_BUFFER(port0);
+static port_t port1 SRAM_BUFFER(port1);
+
+#ifdef CONFIG_UART_COMPRESS
+// Compression state and statistics for traffic from the target.
+lz_t g_compressor SRAM_BUFFER(g_compressor);
+#endif
+
+#ifdef CONFIG_UART_FRAMED
+// Receiver state and statistics of the framed link to the host.
+framelink_t g_hostLink SRAM_BUFFER(g_hostLink);
+#endif
+
+#ifdef CONFIG_UART_ARQ
+// Windows and statistics of the reliable link to the host.
+arq_t g_hostArq SRAM_BUFFER(g_hostArq);
+#endif
+
+#ifdef CONFIG_UART_TAP
+// Output queue and statistics of the tap.
+tapout_t g_tap SRAM_BUFFER(g_tap);
+#endif
+
+#ifdef CONFIG_UART_BERT
+// Settings and results of the bit-error-rate tester, set and read with a
+// debugger.
+bert_t g_bert = {
+  .pattern = CONFIG_UART_BERT_PATTERN,
+  .txPort = 1,
+  .rxPort = 1,
+  .loopback = true,
+};
+#endif
+
+#ifdef CONFIG_UART_BENCH
+// Results of the boot-time benchmark, readable with a debugger.
+bench_t g_bench;
+
+// Cycles spent in the UART top halves since boot.
+static volatile uint32_t g_topHalfCycles;
+
+// Cycle counter at the start and end of BenchProbeHandler.
+static volatile uint32_t g_probeEntry;
+static volatile uint32_t g_probeExit;
+#endif
+
+#ifdef CONFIG_UART_TRACE
+// Trace events dropped because the ITM was busy, readable with a debugger.
+volatile uint32_t g_traceDropped;
+#endif
+
+#ifdef CONFIG_UART_HYBRID
+// Mode transition counters, readable with a debugger.
+volatile hybrid_stats_t g_hybridStats;
+
+// Set by a top half when sustained load is detected, cleared by main() when
+// the ports go idle.
+static volatile bool g_polling;
+#endif
+
+// Timestamps of the boot stages (see boot.h).
+boot_t g_boot;
+
+// The last crash (see crash.h). Never cleared, so that it outlives the reset
+// that follows the crash.
+crash_t g_crash SRAM_NOINIT(g_crash);
+
+// Parameters for UART0
+static const uart_t uart0 = {
+  PORT_HARDWARE(PORT_UPSTREAM)
+  .baudRate = CONFIG_UART_BAUDRATE,
+  .config = (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE
+    | UART_CONFIG_PAR_NONE),
+  .intPriority = UART0_INT_PRIORITY,
+  .intMask = (UART_INT_RX | UART_INT_RT | UART_INT_TX | UART_LINE_ERROR_INTS),
+#ifdef CONFIG_UART_FRAMED
+  .link = &g_hostLink,
+#endif
+#ifdef CONFIG_UART_ARQ
+  .arq = &g_hostArq,
+#endif
+#ifdef CONFIG_UART_TRACE
+  .traceSource = TRACE_UART0,
+#endif
+  .upstream = true,
+};
+
+// Parameters for UART1
+static const uart_t uart1 = {
+  PORT_HARDWARE(PORT_DOWNSTREAM)
+  .baudRate = CONFIG_UART_BAUDRATE,
+  .config = (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE
+    | UART_CONFIG_PAR_NONE),
+  .intPriority = UART1_INT_PRIORITY,
+  .intMask = (UART_INT_RX | UART_INT_RT | UART_INT_TX | UART_LINE_ERROR_INTS),
+#ifdef CONFIG_UART_RS485
+  .halfDuplex = true,
+  .dePeriph = SYSCTL_PERIPH_GPIOE,
+  .deAhbPort = SYSCTL_GPIOHBCTL_PORTE,
+  .deGpioBase = GPIO_PORTE_AHB_BASE,
+  .dePin = GPIO_PIN_1,
+#endif
+#ifdef CONFIG_UART_MULTIDROP
+  .multidrop = true,
+#endif
+#ifdef CONFIG_UART_COMPRESS
+  .compressor = &g_compressor,
+#endif
+#ifdef CONFIG_UART_TRACE
+  .traceSource = TRACE_UART1,
+#endif
+  .upstream = false,
+};
+
+#ifdef CONFIG_UART_TAP
+// Parameters for UART3, which only transmits the tap's records. Only the
+// fields used by ConfigureTap are set.
+static const uart_t uartTap = {
+  .hostGpio = SYSCTL_PERIPH_GPIOC,
+  .hostUart = SYSCTL_PERIPH_UART3,
+  .txPin = GPIO_PC7_U3TX,
+  .gpioBase = GPIO_PORTC_BASE,
+  .gpioPins = GPIO_PIN_7,
+  .uartBase = UART3_BASE,
+  .baudRate = CONFIG_UART_TAP_BAUDRATE,
+  .config = (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE
+    | UART_CONFIG_PAR_NONE),
+  .intHandler = TapUARTHandler,
+  .intNum = INT_UART3,
+  .intPriority = TAP_INT_PRIORITY,
+  .intMask = UART_INT_TX,
+#ifdef CONFIG_UART_TRACE
+  .traceSource = TRACE_TAP,
+#endif
+};
+#endif
+
+/******************************************************************************
+ * FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        IsPolling
+ *
+ * DESCRIPTION:     True when main() is running the forwarding path, false
+ *                  when the interrupts are.
+ ***/
+static inline bool IsPolling(void)
+{
+#if defined(CONFIG_UART_POLL)
+  return true;
+#elif defined(CONFIG_UART_HYBRID)
+  return g_polling;
+#else
+  return false;
+#endif
+}
+
+#ifdef CONFIG_UART_PRIORITY
+/******************************************************************************
+ * FUNCTION:        IsPriorityChar
+ *
+ * DESCRIPTION:     Look up a received char in the port's priority map.
+ ***/
+static inline bool IsPriorityChar(const port_t* port, uint8_t c)
+{
+  return (port->priorityMap[c >> 5] >> (c & 31)) & 1;
+}
+
+#ifdef CONFIG_UART_TAP
+/******************************************************************************
+ * FUNCTION:        TapPriority
+ *
+ * DESCRIPTION:     Top half of the tap, for a priority char, which never goes
+ *                  through the rx queue that TapMark notes runs in. If the
+ *                  bottom half has fallen behind, the char isn't captured.
+ ***/
+static inline void TapPriority(port_t* port, uint8_t c)
+{
+  tap_t* tap = &port->tap;
+  const uint32_t index = tap->priorityHead;
+  if (index - tap->priorityTail >= TAP_MARKS) {
+    tap->latePriority++;
+    return;
+  }
+
+  tap->priority[index & (TAP_MARKS - 1)].stamp = TimebaseNow();
+  tap->priority[index & (TAP_MARKS - 1)].c = c;
+  RING_BARRIER();
+  tap->priorityHead = index + 1;
+}
+#endif
+
+/******************************************************************************
+ * FUNCTION:        SendPriorityChar
+ *
+ * DESCRIPTION:     Queue a priority char for dstUart, ahead of everything
+ *                  still in the software queues, and pend its top half, which
+ *                  drains the priority queue first. Going through FillTxFifo
+ *                  lets a half-duplex port enable its driver before the char
+ *                  goes out. Called from the top half of srcUart, or from the
+ *                  polling loop, which fills every port on each pass anyway.
+ *
+ * ARGUMENTS:       srcUart: The UART the char was received on
+ *                  dstUart: The UART to send it on
+ *                  c: The char
+ ***/
+static void SendPriorityChar(const uart_t* srcUart, const uart_t* dstUart,
+  uint8_t c)
+{
+  port_t* src = srcUart->port;
+  port_t* dst = dstUart->port;
+
+  // Number of bulk chars this one is overtaking.
+  uint32_t bypassed = RingCount(&src->rx) + RingCount(&dst->tx);
+  if (bypassed > src->stats.priorityMaxBypass) {
+    src->stats.priorityMaxBypass = bypassed;
+  }
+
+  if (!RingPush(&dst->prio, c)) {
+    src->stats.rxDropped++;
+    return;
+  }
+
+  if (!IsPolling()) {
+    IntPendSet(dstUart->intNum);
+  }
+#ifdef CONFIG_UART_TAP
+  TapPriority(src, c);
+#endif
+  src->stats.priorityChars++;
+}
+#endif
+
+#ifdef CONFIG_UART_RS485
+/******************************************************************************
+ * FUNCTION:        SetDriverEnable
+ *
+ * DESCRIPTION:     Drive the DE pin of a half-duplex UART. The address bits of
+ *                  the GPIO data register mask the write, so this is a single
+ *                  store that touches no other pin.
+ ***/
+static inline void SetDriverEnable(const uart_t* uart, bool enable)
+{
+  HWREG(uart->deGpioBase + GPIO_O_DATA + (uart->dePin << 2)) =
+    enable ? uart->dePin : 0;
+}
+
+/******************************************************************************
+ * FUNCTION:        TxPending
+ *
+ * DESCRIPTION:     True if any of the port's TX queues has chars in it.
+ ***/
+static inline bool TxPending(const port_t* port)
+{
+  return 0 < RingCount(&port->tx) || 0 < RingCount(&port->echo)
+#ifdef CONFIG_UART_PRIORITY
+    || 0 < RingCount(&port->prio)
+#endif
+    ;
+}
+
+/******************************************************************************
+ * FUNCTION:        DiscardSelfEcho
+ *
+ * DESCRIPTION:     Throw away everything in the RX FIFO of a half-duplex UART
+ *                  while its driver is enabled. With the receiver left on, the
+ *                  transceiver hands back every char we send.
+ *
+ * RETURNS:         The number of characters read from the FIFO.
+ ***/
+static uint32_t DiscardSelfEcho(const uart_t* uart)
+{
+  uint32_t count = 0;
+  while (PortCharsAvail(uart->uartBase)) {
+    PortCharGet(uart->uartBase);
+    count++;
+  }
+
+  UARTRxErrorClear(uart->uartBase);
+  uart->port->rs485.selfEcho += count;
+  return count;
+}
+
+/******************************************************************************
+ * FUNCTION:        ReleaseDriver
+ *
+ * DESCRIPTION:     Called after the TX FIFO of a half-duplex UART has been
+ *                  filled. Once the queues are empty, FillTxFifo has switched
+ *                  the TX interrupt to end-of-transmission mode, so that it
+ *                  fires as the last stop bit leaves the shift register, and
+ *                  the driver is released as soon as the UART is idle.
+ *
+ * ARGUMENTS:       uart: The half-duplex UART.
+ *                  entry: CyclesNow() at entry to the calling handler.
+ ***/
+static void ReleaseDriver(const uart_t* uart, uint32_t entry)
+{
+  rs485_t* rs485 = &uart->port->rs485;
+  if (!rs485->driving || TxPending(uart->port)) {
+    return;
+  }
+
+  // If the last stop bit went out before the mode switch, the EOT interrupt
+  // may never come, so check here too.
+  if (UARTBusy(uart->uartBase)) {
+    return;
+  }
+
+  SetDriverEnable(uart, false);
+  uint32_t now = CyclesNow();
+  rs485->driving = false;
+  rs485->awaitingReply = true;
+  rs485->releasedAt = now;
+  if (now - entry > rs485->releaseMax) {
+    rs485->releaseMax = now - entry;
+  }
+}
+#endif
+
+/******************************************************************************
+ * FUNCTION:        DrainRxFifo
+ *
+ * DESCRIPTION:     Copy everything in the RX FIFO of the UART into the port's
+ *                  rx queue. If the queue is full, the characters are dropped
+ *                  and counted, so that the FIFO can't overrun and the
+ *                  interrupt can't stay asserted. Priority chars skip the
+ *                  queue and go straight to dstUart.
+ *
+ * ARGUMENTS:       uart: The UART to drain.
+ *                  dstUart: The UART that chars from `uart' are routed to.
+ *
+ * RETURNS:         The number of characters read from the FIFO.
+ ***/
+PORT_INLINE uint32_t DrainRxFifo(const uart_t* uart, const uart_t* dstUart)
+{
+  port_t* port = uart->port;
+  uint8_t* span = NULL;
+  uint32_t space = 0;
+  uint32_t count = 0;
+  uint32_t total = 0;
+
+  while (PortCharsAvail(uart->uartBase)) {
+    if (count == space) {
+      RingWriteCommit(&port->rx, count);
+      total += count;
+      count = 0;
+      if (0 == (space = RingWriteSpan(&port->rx, &span))) {
+        PortCharGet(uart->uartBase);
+        port->stats.rxDropped++;
+        TRACE_DROP(uart->traceSource);
+        total++;
+        continue;
+      }
+    }
+
+    // Only read once PortCharsAvail() has said there's a char.
+    uint8_t c = (uint8_t)PortCharGet(uart->uartBase);
+#ifdef CONFIG_UART_PRIORITY
+    if (IsPriorityChar(port, c)) {
+      SendPriorityChar(uart, dstUart, c);
+      total++;
+      continue;
+    }
+#else
+    (void)dstUart;
+#endif
+    span[count++] = c;
+  }
+
+  RingWriteCommit(&port->rx, count);
+  return total + count;
+}
+
+/******************************************************************************
+ * FUNCTION:        StartBreak
+ *
+ * DESCRIPTION:     Forward a break received on srcUart by holding dstUart's
+ *                  TX line low. The break timer of srcUart releases it once
+ *                  the break on srcUart has ended.
+ *
+ * ARGUMENTS:       srcUart: The UART the break was received on
+ *                  dstUart: The UART to send it on
+ ***/
+static void StartBreak(const uart_t* srcUart, const uart_t* dstUart)
+{
+  srcUart->port->stats.breaks++;
+  srcUart->port->breakTicks = 0;
+  UARTBreakCtl(dstUart->uartBase, true);
+  TimerEnable(srcUart->breakTimer.base, TIMER_A);
+}
+
+/******************************************************************************
+ * FUNCTION:        DrainRxFifoChecked
+ *
+ * DESCRIPTION:     Slow path of DrainRxFifo, taken when the UART has flagged
+ *                  a line condition. Looks at the error bits of every char:
+ *                  breaks are forwarded with StartBreak, framing and parity
+ *                  errors are counted and the char is forwarded anyway, as it
+ *                  would be by a wire.
+ *
+ * ARGUMENTS:       uart: The UART to drain.
+ *                  dstUart: The UART that chars from `uart' are routed to.
+ *                  status: The interrupt status that got us here.
+ *
+ * RETURNS:         The number of characters read from the FIFO.
+ ***/
+static __attribute__((noinline)) uint32_t DrainRxFifoChecked(
+  const uart_t* uart, const uart_t* dstUart, uint32_t status)
+{
+  port_t* port = uart->port;
+  uint32_t total = 0;
+
+  // An overrun is flagged on the char after the ones that were lost, so
+  // count it from the interrupt instead of the data register.
+  if (status & UART_INT_OE) {
+    port->stats.overruns++;
+    TRACE_OVERRUN(uart->traceSource);
+  }
+
+  while (PortCharsAvail(uart->uartBase)) {
+    uint32_t c = PortCharGet(uart->uartBase);
+    total++;
+    if (c & UART_DR_BE) {
+      StartBreak(uart, dstUart);
+      continue;
+    } else if (c & UART_DR_FE) {
+      port->stats.framingErrors++;
+    } else if (c & UART_DR_PE) {
+      port->stats.parityErrors++;
+    }
+
+#ifdef CONFIG_UART_PRIORITY
+    if (IsPriorityChar(port, (uint8_t)c)) {
+      SendPriorityChar(uart, dstUart, (uint8_t)c);
+      continue;
+    }
+#endif
+#ifdef CONFIG_UART_GAP
+    if (0 < RingSpace(&port->rx)) {
+      port->gap.stamps[port->rx.head & port->rx.mask] = TimebaseNow();
+    }
+#endif
+    if (!RingPush(&port->rx, (uint8_t)c)) {
+      port->stats.rxDropped++;
+      TRACE_DROP(uart->traceSource);
+    }
+  }
+
+  UARTRxErrorClear(uart->uartBase);
+  return total;
+}
+
+/******************************************************************************
+ * FUNCTION:        ServiceRx
+ *
+ * DESCRIPTION:     Drain the RX FIFO of the UART, taking the slow path only
+ *                  if `status' shows a line condition. In gap mode, every
+ *                  char needs a timestamp, so the slow path is always taken.
+ *                  A half-duplex UART discards what it receives while it is
+ *                  driving the bus.
+ *
+ * ARGUMENTS:       uart: The UART to drain.
+ *                  dstUart: The UART that chars from `uart' are routed to.
+ *                  status: Interrupt status of the UART.
+ *
+ * RETURNS:         The number of characters read from the FIFO.
+ ***/
+PORT_INLINE uint32_t ServiceRx(const uart_t* uart, const uart_t* dstUart,
+  uint32_t status)
+{
+#ifdef CONFIG_UART_RS485
+  if (uart->halfDuplex) {
+    rs485_t* rs485 = &uart->port->rs485;
+    if (rs485->driving) {
+      return DiscardSelfEcho(uart);
+    }
+
+    if (rs485->awaitingReply && PortCharsAvail(uart->uartBase)) {
+      rs485->awaitingReply = false;
+      rs485->replyLast = CyclesNow() - rs485->releasedAt;
+      if (rs485->replyLast > rs485->replyMax) {
+        rs485->replyMax = rs485->replyLast;
+      }
+    }
+  }
+#endif
+
+#ifdef CONFIG_UART_GAP
+  return DrainRxFifoChecked(uart, dstUart, status);
+#else
+  if (status & UART_LINE_ERROR_INTS) {
+    return DrainRxFifoChecked(uart, dstUart, status);
+  }
+
+  return DrainRxFifo(uart, dstUart);
+#endif
+}
+
+#ifdef CONFIG_UART_TAP
+/******************************************************************************
+ * FUNCTION:        TapMark
+ *
+ * DESCRIPTION:     Top half of the tap. Note where the run of chars just read
+ *                  into the rx queue of the port ends, and when it was read,
+ *                  which is all the tap costs a top half. If the bottom half
+ *                  has fallen behind, the run is left for the next mark.
+ ***/
+static inline void TapMark(port_t* port)
+{
+  tap_t* tap = &port->tap;
+  const uint32_t head = port->rx.head;
+  const uint32_t index = tap->markHead;
+  if (head == tap->lastHead) {
+    return;
+  }
+
+  if (index - tap->markTail >= TAP_MARKS) {
+    tap->lateMarks++;
+    return;
+  }
+
+  tap->marks[index & (TAP_MARKS - 1)].stamp = TimebaseNow();
+  tap->marks[index & (TAP_MARKS - 1)].head = head;
+  RING_BARRIER();
+  tap->markHead = index + 1;
+  tap->lastHead = head;
+}
+#endif
+
+/******************************************************************************
+ * FUNCTION:        FillFromRing
+ *
+ * DESCRIPTION:     Move as many characters from `ring' into the TX FIFO of
+ *                  the UART as will fit.
+ *
+ * ARGUMENTS:       uart: The UART to fill.
+ *                  ring: The queue to take characters from.
+ *
+ * RETURNS:         false if the FIFO filled up before the queue was empty.
+ ***/
+PORT_INLINE bool FillFromRing(const uart_t* uart, ringbuf_t* ring)
+{
+  const uint8_t* span = NULL;
+  uint32_t length = 0;
+  uint32_t count = 0;
+  uint32_t sent = 0;
+
+  while (0 < (length = RingReadSpan(ring, &span))) {
+    for (count = 0; count < length; ++count) {
+      if (!PortCharPut(uart->uartBase, span[count])) {
+        break;
+      }
+    }
+
+    RingReadCommit(ring, count);
+    sent += count;
+    if (count < length) {
+      TRACE_TX(uart->traceSource, sent);
+      TRACE_FIFO_FULL(uart->traceSource);
+      return false;
+    }
+  }
+
+  TRACE_TX(uart->traceSource, sent);
+  return true;
+}
+
+#ifdef CONFIG_UART_MULTIDROP
+/******************************************************************************
+ * FUNCTION:        MultidropDataMode
+ *
+ * DESCRIPTION:     Put a multidrop UART back in data mode once the address
+ *                  char it's sending has gone out. Until then, any char
+ *                  written to the TX FIFO would go out as an address too.
+ *
+ * ARGUMENTS:       uart: The multidrop UART.
+ *
+ * RETURNS:         false if the address char is still going out.
+ ***/
+static inline bool MultidropDataMode(const uart_t* uart)
+{
+  multidrop_t* multidrop = &uart->port->multidrop;
+  if (multidrop->sending) {
+    if (UARTBusy(uart->uartBase)) {
+      return false;
+    }
+
+    HWREG(uart->uartBase + UART_O_LCRH) = multidrop->lcrh;
+    multidrop->sending = false;
+  }
+
+  return true;
+}
+
+/******************************************************************************
+ * FUNCTION:        FillMultidrop
+ *
+ * DESCRIPTION:     FillFromRing for the tx queue of a multidrop UART. Escape
+ *                  sequences in the queue are decoded: an address is sent as
+ *                  an address char (9th bit set), and a doubled escape as a
+ *                  literal 0xff. The 9th bit is taken from the parity setting,
+ *                  so an address can only be written once the UART is idle,
+ *                  and the setting is restored once it has gone out.
+ *
+ * ARGUMENTS:       uart: The UART to fill.
+ *
+ * RETURNS:         true if nothing more can be sent until the UART is idle.
+ ***/
+static bool FillMultidrop(const uart_t* uart)
+{
+  port_t* port = uart->port;
+  multidrop_t* multidrop = &port->multidrop;
+  const uint8_t* span = NULL;
+  uint32_t length = 0;
+  uint32_t count = 0;
+
+  if (!MultidropDataMode(uart)) {
+    return true;
+  }
+
+  while (0 < (length = RingReadSpan(&port->tx, &span))) {
+    if (MULTIDROP_ESCAPE != span[0]) {
+      // A run of data chars, up to the next escape.
+      const uint8_t* escape = memchr(span, MULTIDROP_ESCAPE, length);
+      length = NULL != escape ? (uint32_t)(escape - span) : length;
+      for (count = 0; count < length; ++count) {
+        if (!PortCharPut(uart->uartBase, span[count])) {
+          break;
+        }
+      }
+
+      RingReadCommit(&port->tx, count);
+      if (count < length) {
+        return false;
+      }
+      continue;
+    }
+
+    // The rest of the sequence hasn't arrived yet. The bottom half will
+    // pend us when it does.
+    if (RingCount(&port->tx) < 2) {
+      return false;
+    }
+
+    RingPeekSpan(&port->tx, 1, &span);
+    uint8_t c = span[0];
+    if (MULTIDROP_ESCAPE == c) {
+      if (!PortCharPut(uart->uartBase, c)) {
+        return false;
+      }
+
+      RingReadCommit(&port->tx, 2);
+      continue;
+    }
+
+    if (UARTBusy(uart->uartBase)) {
+      return true;
+    }
+
+    uint32_t lcrh = HWREG(uart->uartBase + UART_O_LCRH);
+    multidrop->lcrh = lcrh;
+    HWREG(uart->uartBase + UART_O_LCRH) = (lcrh & ~UART_LCRH_EPS)
+      | UART_LCRH_SPS | UART_LCRH_PEN;
+    PortCharPut(uart->uartBase, c);
+    RingReadCommit(&port->tx, 2);
+    multidrop->sending = true;
+    multidrop->addresses++;
+    return true;
+  }
+
+  return false;
+}
+#endif
+
+/******************************************************************************
+ * FUNCTION:        FillForward
+ *
+ * DESCRIPTION:     Move as many characters from the tx queue of the port into
+ *                  the TX FIFO of the UART as will fit.
+ *
+ * ARGUMENTS:       uart: The UART to fill.
+ *
+ * RETURNS:         true if nothing more can be sent until the UART is idle.
+ ***/
+PORT_INLINE bool FillForward(const uart_t* uart)
+{
+#ifdef CONFIG_UART_MULTIDROP
+  if (uart->multidrop) {
+    return FillMultidrop(uart);
+  }
+#endif
+
+  FillFromRing(uart, &uart->port->tx);
+  return false;
+}
+
+/******************************************************************************
+ * FUNCTION:        FillTxFifo
+ *
+ * DESCRIPTION:     Move as many characters from the port's queues into the
+ *                  TX FIFO of the UART as will fit. When the FIFO drains past
+ *                  its trigger level, the TX interrupt brings us back here.
+ *                  A half-duplex UART enables its driver before the first
+ *                  char is written.
+ *
+ * ARGUMENTS:       uart: The UART to fill.
+ ***/
+PORT_INLINE void FillTxFifo(const uart_t* uart)
+{
+  port_t* port = uart->port;
+
+#ifdef CONFIG_UART_RS485
+  if (uart->halfDuplex && !port->rs485.driving) {
+    if (!TxPending(port)) {
+      return;
+    }
+
+    SetDriverEnable(uart, true);
+    port->rs485.driving = true;
+    port->rs485.awaitingReply = false;
+    port->rs485.transmissions++;
+  }
+#endif
+
+#ifdef CONFIG_UART_MULTIDROP
+  // Priority and echo chars wait for the address char too. The TX interrupt
+  // is already in end-of-transmission mode for it.
+  if (uart->multidrop && !MultidropDataMode(uart)) {
+    return;
+  }
+#endif
+
+#ifdef CONFIG_UART_PRIORITY
+  uint8_t c = 0;
+  while (0 < RingCount(&port->prio)) {
+    if (!PortSpaceAvail(uart->uartBase)) {
+      return;
+    }
+
+    RingPop(&port->prio, &c);
+    PortCharPut(uart->uartBase, c);
+  }
+#endif
+
+  // Echo first: it's what the user at this end is waiting to see.
+  bool waitIdle = false;
+  if (FillFromRing(uart, &port->echo)) {
+    waitIdle = FillForward(uart);
+  }
+
+#if defined(CONFIG_UART_RS485) || defined(CONFIG_UART_MULTIDROP)
+  // Come back when the line goes idle instead of at the FIFO level, if
+  // that's what we're waiting for.
+#ifdef CONFIG_UART_RS485
+  waitIdle = waitIdle || (uart->halfDuplex && !TxPending(port));
+#endif
+  if (waitIdle != port->txEot) {
+    UARTTxIntModeSet(uart->uartBase,
+      waitIdle ? UART_TXINT_MODE_EOT : UART_TXINT_MODE_FIFO);
+    port->txEot = waitIdle;
+  }
+#else
+  (void)waitIdle;
+#endif
+}
+
+#ifdef CONFIG_UART_HYBRID
+/******************************************************************************
+ * FUNCTION:        EnterPollMode
+ *
+ * DESCRIPTION:     Mask every UART interrupt source and hand the forwarding
+ *                  path to main(). Called from a top half.
+ ***/
+static void EnterPollMode(void)
+{
+  UARTIntDisable(uart0.uartBase, uart0.intMask);
+  UARTIntDisable(uart1.uartBase, uart1.intMask);
+  port0.burstRuns = 0;
+  port1.burstRuns = 0;
+  g_polling = true;
+  g_hybridStats.pollEntries++;
+  TRACE_MODE(TRACE_MODE_POLL);
+}
+
+/******************************************************************************
+ * FUNCTION:        ExitPollMode
+ *
+ * DESCRIPTION:     Give the forwarding path back to the interrupts. Called
+ *                  from main() with interrupts masked.
+ ***/
+static void ExitPollMode(void)
+{
+  g_polling = false;
+  g_hybridStats.pollExits++;
+  TRACE_MODE(TRACE_MODE_INTERRUPT);
+  UARTIntEnable(uart0.uartBase, uart0.intMask);
+  UARTIntEnable(uart1.uartBase, uart1.intMask);
+
+  // Anything that arrived since the last poll may already be past the FIFO
+  // trigger level, so run the top halves once to pick it up.
+  IntPendSet(uart0.intNum);
+  IntPendSet(uart1.intNum);
+}
+#endif
+
+#ifdef CONFIG_UART_GAP
+/******************************************************************************
+ * FUNCTION:        GapReplay
+ *
+ * DESCRIPTION:     Move every char in the rx queue of srcUart whose slot has
+ *                  come to the tx queue of dstUart, and arm the gap timer of
+ *                  srcUart for the slot of the next one. Runs from the top
+ *                  half of srcUart and from its gap timer, which share a
+ *                  priority, so it is never reentered.
+ *
+ * ARGUMENTS:       srcUart: The UART the chars were received on
+ *                  dstUart: The UART to send them on
+ ***/
+static void GapReplay(const uart_t* srcUart, const uart_t* dstUart)
+{
+  port_t* src = srcUart->port;
+  port_t* dst = dstUart->port;
+  gap_t* gap = &src->gap;
+  const uint32_t delay = gap->delay;
+  uint32_t moved = 0;
+  uint8_t c = 0;
+
+  TimerDisable(srcUart->gapTimer.base, TIMER_A);
+  while (0 < RingCount(&src->rx)) {
+    uint32_t stamp = gap->stamps[src->rx.tail & src->rx.mask];
+    int32_t wait = (int32_t)(stamp + delay - TimebaseNow());
+    if (0 < wait) {
+      TimerLoadSet(srcUart->gapTimer.base, TIMER_A, (uint32_t)wait);
+      TimerEnable(srcUart->gapTimer.base, TIMER_A);
+      break;
+    }
+
+    if ((uint32_t)-wait > gap->late) {
+      gap->late = (uint32_t)-wait;
+    }
+    if (stamp - gap->lastStamp >= gap->frameGap) {
+      gap->frames++;
+    }
+    gap->lastStamp = stamp;
+
+    RingPop(&src->rx, &c);
+    if (RingPush(&dst->tx, c)) {
+      moved++;
+    } else {
+      src->stats.rxDropped++;
+    }
+  }
+
+  if (0 < moved) {
+    src->stats.rxBytes += moved;
+    dst->stats.txBytes += moved;
+    TRACE_FORWARD(srcUart->traceSource, moved);
+    IntPendSet(dstUart->intNum);
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:        GenericGapTimerHandler
+ *
+ * DESCRIPTION:     The slot of the oldest char received on srcUart has come.
+ *
+ * ARGUMENTS:       srcUart: The UART whose gap timer expired.
+ *                  dstUart: The UART that chars from srcUart are routed to.
+ ***/
+PORT_INLINE void GenericGapTimerHandler(const uart_t* srcUart,
+  const uart_t* dstUart)
+{
+  TimerIntClear(srcUart->gapTimer.base, TIMER_TIMA_TIMEOUT);
+  GapReplay(srcUart, dstUart);
+}
+
+/******************************************************************************
+ * FUNCTION:        GapTimerZeroHandler, GapTimerOneHandler
+ *
+ * DESCRIPTION:     Handle the gap timer of each port.
+ ***/
+BRIDGE_PORTS(PORT_GAP_HANDLER)
+#endif
+
+/******************************************************************************
+ * FUNCTION:        GenericUARTIntHandler
+ *
+ * DESCRIPTION:     Top half of the UART interrupt. Move chars from the RX
+ *                  FIFO into the rx queue and from the tx queue into the TX
+ *                  FIFO, then leave everything else to the bottom half. The
+ *                  bottom half pends this interrupt when it queues data for
+ *                  this UART.
+ *
+ * ARGUMENTS:       uart: The UART that raised the interrupt.
+ *                  dstUart: The UART that chars from `uart' are routed to.
+ ***/
+PORT_INLINE void GenericUARTIntHandler(const uart_t* uart,
+  const uart_t* dstUart)
+{
+#if defined(CONFIG_UART_RS485) || defined(CONFIG_UART_BENCH)
+  const uint32_t entry = CyclesNow();
+#endif
+
+  TRACE_ENTER(uart->traceSource);
+
+  // Clear interrupt status
+  uint32_t status = PortIntStatus(uart->uartBase, true);
+  PortIntClear(uart->uartBase, status);
+
+  MARKER_HIGH(MARKER_RX);
+  const uint32_t received = ServiceRx(uart, dstUart, status);
+  MARKER_LOW(MARKER_RX);
+  TRACE_RX(uart->traceSource, received);
+#ifdef CONFIG_UART_HYBRID
+  if (received >= CONFIG_UART_HYBRID_BURST) {
+    if (++uart->port->burstRuns >= CONFIG_UART_HYBRID_RUNS) {
+      EnterPollMode();
+    }
+  } else {
+    uart->port->burstRuns = 0;
+  }
+#endif
+#ifdef CONFIG_UART_TAP
+  TapMark(uart->port);
+#endif
+  FillTxFifo(uart);
+#ifdef CONFIG_UART_RS485
+  if (uart->halfDuplex) {
+    ReleaseDriver(uart, entry);
+  }
+#endif
+
+#ifdef CONFIG_UART_GAP
+  // Chars are forwarded on their own schedule, not by the bottom half.
+  GapReplay(uart, dstUart);
+#else
+  // Schedule the bottom half. This is cheaper than checking whether there's
+  // anything for it to do, since it will find out anyway.
+  HWREG(NVIC_INT_CTRL) = NVIC_INT_CTRL_PEND_SV;
+#endif
+#ifdef CONFIG_UART_BENCH
+  g_topHalfCycles += CyclesNow() - entry;
+#endif
+  TRACE_EXIT(uart->traceSource);
+}
+
+/******************************************************************************
+ * FUNCTION:        UARTZeroHandler, UARTOneHandler
+ *
+ * DESCRIPTION:     Handle interrupts from each port's UART.
+ ***/
+BRIDGE_PORTS(PORT_UART_HANDLER)
+
+/******************************************************************************
+ * FUNCTION:        GenericBreakTimerHandler
+ *
+ * DESCRIPTION:     Runs once per character time while a break received on
+ *                  srcUart is being forwarded. Releases the break on dstUart
+ *                  once srcUart's RX line has gone back to idle, and the break
+ *                  has lasted long enough to be detected.
+ *
+ * ARGUMENTS:       srcUart: The UART the break was received on
+ *                  dstUart: The UART it's being sent on
+ ***/
+PORT_INLINE void GenericBreakTimerHandler(const uart_t* srcUart,
+  const uart_t* dstUart)
+{
+  TimerIntClear(srcUart->breakTimer.base, TIMER_TIMA_TIMEOUT);
+  if (++srcUart->port->breakTicks < BREAK_MIN_CHARS) {
+    return;
+  }
+
+  if (ROM_GPIOPinRead(srcUart->gpioBase, srcUart->rxGpioPin)) {
+    TimerDisable(srcUart->breakTimer.base, TIMER_A);
+    UARTBreakCtl(dstUart->uartBase, false);
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:        BreakTimerZeroHandler, BreakTimerOneHandler
+ *
+ * DESCRIPTION:     Handle the break timer of each port.
+ ***/
+BRIDGE_PORTS(PORT_BREAK_HANDLER)
+
+#ifdef CONFIG_UART_COALESCE
+/******************************************************************************
+ * FUNCTION:        CoalesceFindDelimiter
+ *
+ * DESCRIPTION:     Search the rx queue of the port for the delimiter, between
+ *                  offsets `start' and `end' from the first queued char.
+ ***/
+static bool CoalesceFindDelimiter(port_t* port, uint32_t start, uint32_t end)
+{
+  const uint8_t* span = NULL;
+  uint32_t length = 0;
+
+  while (start < end && 0 < (length = RingPeekSpan(&port->rx, start, &span))) {
+    length = length < end - start ? length : end - start;
+    if (NULL != memchr(span, port->coalesce.delimiter, length)) {
+      return true;
+    }
+    start += length;
+  }
+
+  return false;
+}
+
+/******************************************************************************
+ * FUNCTION:        CoalesceRelease
+ *
+ * DESCRIPTION:     Decide how many of the chars in the rx queue of the UART
+ *                  may be forwarded now. Chars that are held arm the
+ *                  coalescing timer, which pends the bottom half again when
+ *                  the inter-byte timeout or the maximum latency runs out.
+ *
+ * ARGUMENTS:       uart: The UART whose rx queue is being coalesced.
+ *
+ * RETURNS:         The number of chars that may be forwarded.
+ ***/
+static uint32_t CoalesceRelease(const uart_t* uart)
+{
+  coalesce_t* coalesce = &uart->port->coalesce;
+  uint32_t pending = RingCount(&uart->port->rx);
+  uint32_t base = uart->coalesceTimer.base;
+
+  // Settings may have been changed underneath us.
+  if (coalesce->released > pending || coalesce->scanned > pending) {
+    coalesce->released = coalesce->scanned = pending;
+  }
+
+  if (coalesce->released == pending) {
+    coalesce->armedCount = pending;
+    return pending;
+  }
+
+  // Start timing the oldest held char.
+  if (coalesce->armedCount == coalesce->released) {
+    coalesce->heldSince = CyclesNow();
+  }
+
+  uint32_t cyclesPerUs = coalesce->cyclesPerUs;
+  uint32_t heldUs = (CyclesNow() - coalesce->heldSince) / cyclesPerUs;
+  bool flush = coalesce->timedOut
+    || pending - coalesce->released >= coalesce->size
+    || heldUs >= coalesce->maxUs
+    || CoalesceFindDelimiter(uart->port, coalesce->scanned, pending);
+  coalesce->timedOut = false;
+  coalesce->scanned = pending;
+
+  if (flush) {
+    TimerDisable(base, TIMER_A);
+    coalesce->flushes++;
+    coalesce->released = coalesce->armedCount = pending;
+  } else if (coalesce->armedCount != pending) {
+    // New chars arrived: restart the inter-byte timeout, but never past the
+    // maximum latency of the oldest held char.
+    uint32_t timeoutUs = coalesce->maxUs - heldUs;
+    timeoutUs = timeoutUs < coalesce->timeoutUs
+      ? timeoutUs : coalesce->timeoutUs;
+    TimerDisable(base, TIMER_A);
+    TimerLoadSet(base, TIMER_A, timeoutUs * cyclesPerUs);
+    TimerEnable(base, TIMER_A);
+    coalesce->armedCount = pending;
+  }
+
+  return coalesce->released;
+}
+
+/******************************************************************************
+ * FUNCTION:        CoalesceForwarded
+ *
+ * DESCRIPTION:     Account for `count' chars removed from the front of the rx
+ *                  queue of the port by the bottom half.
+ ***/
+static inline void CoalesceForwarded(port_t* port, uint32_t count)
+{
+  port->coalesce.released -= count;
+  port->coalesce.scanned -= count;
+  port->coalesce.armedCount -= count;
+}
+
+/******************************************************************************
+ * FUNCTION:        GenericCoalesceTimerHandler
+ *
+ * DESCRIPTION:     The coalescing timeout of the UART ran out. Release what
+ *                  it's holding on the next run of the bottom half.
+ *
+ * ARGUMENTS:       uart: The UART whose coalescing timer expired.
+ ***/
+PORT_INLINE void GenericCoalesceTimerHandler(const uart_t* uart)
+{
+  TimerIntClear(uart->coalesceTimer.base, TIMER_TIMA_TIMEOUT);
+  uart->port->coalesce.timedOut = true;
+
+  // In polling mode, the next pass of the loop will see the flag.
+  if (!IsPolling()) {
+    HWREG(NVIC_INT_CTRL) = NVIC_INT_CTRL_PEND_SV;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:        CoalesceTimerZeroHandler, CoalesceTimerOneHandler
+ *
+ * DESCRIPTION:     Handle the coalescing timer of each port.
+ ***/
+BRIDGE_PORTS(PORT_COALESCE_HANDLER)
+#endif
+
+/******************************************************************************
+ * FUNCTION:        CopyRx
+ *
+ * DESCRIPTION:     Copy up to `limit' chars from the rx queue of `src' to the
+ *                  tx queue of `dst', and to the echo queue of `src' if
+ *                  `echoEnabled'. Stops when either destination is full.
+ *
+ * RETURNS:         The number of chars taken from the rx queue.
+ ***/
+static uint32_t CopyRx(port_t* src, port_t* dst, uint32_t limit,
+  bool echoEnabled)
+{
+  const uint8_t* in = NULL;
+  uint8_t* out = NULL;
+  uint32_t length = 0;
+  uint32_t total = 0;
+
+  while (total < limit && 0 < (length = RingReadSpan(&src->rx, &in))) {
+    length = length < limit - total ? length : limit - total;
+    uint32_t space = RingWriteSpan(&dst->tx, &out);
+    length = length < space ? length : space;
+    uint8_t* echo = NULL;
+    if (echoEnabled) {
+      space = RingWriteSpan(&src->echo, &echo);
+      length = length < space ? length : space;
+    }
+    if (0 == length) {
+      break;
+    }
+
+    memcpy(out, in, length);
+    RingWriteCommit(&dst->tx, length);
+    if (echoEnabled) {
+      memcpy(echo, in, length);
+      RingWriteCommit(&src->echo, length);
+    }
+    RingReadCommit(&src->rx, length);
+    total += length;
+  }
+
+  dst->stats.txBytes += total;
+  return total;
+}
+
+#ifdef CONFIG_UART_COMPRESS
+/******************************************************************************
+ * FUNCTION:        CompressRx
+ *
+ * DESCRIPTION:     Like CopyRx, but the chars are compressed on their way to
+ *                  the tx queue of `dst'. The compressor is flushed whenever
+ *                  the rx queue runs dry, so compression never holds data
+ *                  back. Echo is not compressed.
+ *
+ * RETURNS:         The number of chars taken from the rx queue.
+ ***/
+static uint32_t CompressRx(port_t* src, port_t* dst, lz_t* lz, uint32_t limit,
+  bool echoEnabled)
+{
+  static uint8_t staging[LZ_BOUND(COMPRESS_CHUNK)];
+  const uint8_t* in = NULL;
+  uint32_t length = 0;
+  uint32_t total = 0;
+  uint32_t written = 0;
+  uint32_t start = CyclesNow();
+
+  while (total < limit && 0 < (length = RingReadSpan(&src->rx, &in))) {
+    length = length < limit - total ? length : limit - total;
+    length = length < COMPRESS_CHUNK ? length : COMPRESS_CHUNK;
+    if (RingSpace(&dst->tx) < LZ_BOUND(length)
+      || (echoEnabled && RingSpace(&src->echo) < length)) {
+      break;
+    }
+
+    uint32_t count = LzCompress(lz, in, length, staging);
+    RingPushBulk(&dst->tx, staging, count);
+    if (echoEnabled) {
+      RingPushBulk(&src->echo, in, length);
+    }
+    RingReadCommit(&src->rx, length);
+    written += count;
+    total += length;
+  }
+
+  if (0 == RingCount(&src->rx) && RingSpace(&dst->tx) >= LZ_MAX_LITERALS) {
+    uint32_t count = LzFlush(lz, staging);
+    RingPushBulk(&dst->tx, staging, count);
+    written += count;
+  }
+
+  lz->cycles += CyclesNow() - start;
+  dst->stats.txBytes += written;
+  return total;
+}
+#endif
+
+#ifdef CONFIG_UART_FRAMED
+/******************************************************************************
+ * FUNCTION:        FrameRx
+ *
+ * DESCRIPTION:     Like CopyRx, but each run of up to FRAME_MAX_PAYLOAD chars
+ *                  is sent to the tx queue of `dst' as a frame on `link'.
+ *                  Echo is not framed.
+ *
+ * RETURNS:         The number of chars taken from the rx queue.
+ ***/
+static uint32_t FrameRx(port_t* src, port_t* dst, framelink_t* link,
+  uint32_t limit, bool echoEnabled)
+{
+  static uint8_t staging[FRAME_BOUND(FRAME_MAX_PAYLOAD)];
+  const uint8_t* in = NULL;
+  uint32_t length = 0;
+  uint32_t total = 0;
+
+  while (total < limit && 0 < (length = RingReadSpan(&src->rx, &in))) {
+    length = length < limit - total ? length : limit - total;
+    length = length < FRAME_MAX_PAYLOAD ? length : FRAME_MAX_PAYLOAD;
+    if (RingSpace(&dst->tx) < FRAME_BOUND(length)
+      || (echoEnabled && RingSpace(&src->echo) < length)) {
+      break;
+    }
+
+    uint32_t count = FrameEncode(link, in, length, staging);
+    RingPushBulk(&dst->tx, staging, count);
+    if (echoEnabled) {
+      RingPushBulk(&src->echo, in, length);
+    }
+    RingReadCommit(&src->rx, length);
+    dst->stats.txBytes += count;
+    total += length;
+  }
+
+  return total;
+}
+
+/******************************************************************************
+ * FUNCTION:        DeframeRx
+ *
+ * DESCRIPTION:     Like CopyRx, but the rx queue of `src' carries frames on
+ *                  `link', and only the payloads of good frames are sent to
+ *                  the tx queue of `dst'. Chars are only taken while a whole
+ *                  payload would fit.
+ *
+ * RETURNS:         The number of chars taken from the rx queue.
+ ***/
+static uint32_t DeframeRx(port_t* src, port_t* dst, framelink_t* link,
+  uint32_t limit)
+{
+  const uint8_t* in = NULL;
+  uint32_t length = 0;
+  uint32_t total = 0;
+
+  while (total < limit && RingSpace(&dst->tx) >= FRAME_MAX_PAYLOAD
+    && 0 < (length = RingReadSpan(&src->rx, &in))) {
+    length = length < limit - total ? length : limit - total;
+    uint32_t count = 0;
+    while (count < length) {
+      uint32_t payload = FrameReceive(link, in[count++]);
+      if (0 < payload) {
+        RingPushBulk(&dst->tx, link->buffer, payload);
+        dst->stats.txBytes += payload;
+        if (RingSpace(&dst->tx) < FRAME_MAX_PAYLOAD) {
+          break;
+        }
+      }
+    }
+
+    RingReadCommit(&src->rx, count);
+    total += count;
+  }
+
+  return total;
+}
+#endif
+
+#ifdef CONFIG_UART_ARQ
+/******************************************************************************
+ * FUNCTION:        QueueFrame
+ *
+ * DESCRIPTION:     Send an ARQ packet to the tx queue of `dst' as a frame on
+ *                  `link'. The caller checks for FRAME_BOUND() of space.
+ ***/
+static void QueueFrame(port_t* dst, framelink_t* link, const uint8_t* packet,
+  uint32_t length)
+{
+  static uint8_t staging[FRAME_BOUND(FRAME_MAX_PAYLOAD)];
+  uint32_t count = FrameEncode(link, packet, length, staging);
+  RingPushBulk(&dst->tx, staging, count);
+  dst->stats.txBytes += count;
+}
+
+/******************************************************************************
+ * FUNCTION:        ArqFrameRx
+ *
+ * DESCRIPTION:     Like FrameRx, but each frame is a packet of `arq'. Pending
+ *                  ACKs, NAKs and retransmissions are sent first, then new
+ *                  chars while the window is open. Chars are left in the rx
+ *                  queue while it's closed.
+ *
+ * RETURNS:         The number of chars taken from the rx queue.
+ ***/
+static uint32_t ArqFrameRx(port_t* src, port_t* dst, framelink_t* link,
+  arq_t* arq, uint32_t limit, bool echoEnabled)
+{
+  static uint8_t packet[FRAME_MAX_PAYLOAD];
+  const uint32_t now = CyclesNow();
+  const uint8_t* in = NULL;
+  uint32_t length = 0;
+  uint32_t total = 0;
+
+  while (RingSpace(&dst->tx) >= FRAME_BOUND(FRAME_MAX_PAYLOAD)
+    && 0 < (length = ArqPoll(arq, now, packet))) {
+    QueueFrame(dst, link, packet, length);
+  }
+
+  while (total < limit && ArqCanSend(arq)
+    && RingSpace(&dst->tx) >= FRAME_BOUND(FRAME_MAX_PAYLOAD)
+    && 0 < (length = RingReadSpan(&src->rx, &in))) {
+    length = length < limit - total ? length : limit - total;
+    length = length < ARQ_MAX_PAYLOAD ? length : ARQ_MAX_PAYLOAD;
+    if (echoEnabled && RingSpace(&src->echo) < length) {
+      break;
+    }
+
+    QueueFrame(dst, link, packet, ArqSend(arq, in, length, now, packet));
+    if (echoEnabled) {
+      RingPushBulk(&src->echo, in, length);
+    }
+    RingReadCommit(&src->rx, length);
+    total += length;
+  }
+
+  return total;
+}
+
+/******************************************************************************
+ * FUNCTION:        ArqDeliver
+ *
+ * DESCRIPTION:     Move in-order packets of `arq' to the tx queue of `dst',
+ *                  while they fit.
+ ***/
+static void ArqDeliver(port_t* dst, arq_t* arq)
+{
+  const uint8_t* data = NULL;
+  uint32_t length = 0;
+
+  while (0 < (length = ArqPeek(arq, &data))
+    && RingSpace(&dst->tx) >= length) {
+    RingPushBulk(&dst->tx, data, length);
+    dst->stats.txBytes += length;
+    ArqRelease(arq);
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:        ArqDeframeRx
+ *
+ * DESCRIPTION:     Like DeframeRx, but each good frame is a packet of `arq',
+ *                  and data is sent to the tx queue of `dst' in order. The rx
+ *                  queue is always drained: data that can't be delivered yet
+ *                  is held in the window, and the window closing is what
+ *                  holds back the other end. Replies are sent by ArqFrameRx.
+ *
+ * RETURNS:         The number of chars taken from the rx queue.
+ ***/
+static uint32_t ArqDeframeRx(port_t* src, port_t* dst, framelink_t* link,
+  arq_t* arq, uint32_t limit)
+{
+  const uint8_t* in = NULL;
+  uint32_t length = 0;
+  uint32_t total = 0;
+
+  while (total < limit && 0 < (length = RingReadSpan(&src->rx, &in))) {
+    length = length < limit - total ? length : limit - total;
+    for (uint32_t i = 0; i < length; ++i) {
+      uint32_t payload = FrameReceive(link, in[i]);
+      if (0 < payload) {
+        ArqReceive(arq, link->buffer, payload);
+        ArqDeliver(dst, arq);
+      }
+    }
+
+    RingReadCommit(&src->rx, length);
+    total += length;
+  }
+
+  // The tx queue may have drained since the last packet arrived.
+  ArqDeliver(dst, arq);
+  return total;
+}
+
+/******************************************************************************
+ * FUNCTION:        ArqTimerHandler
+ *
+ * DESCRIPTION:     SysTick handler. Runs the bottom half periodically while
+ *                  packets are unacknowledged, so that they are sent again
+ *                  when they time out even if the line has gone quiet.
+ ***/
+void ArqTimerHandler(void) {
+  if (ArqBusy(&g_hostArq)) {
+    IntPendSet(FAULT_PENDSV);
+  }
+}
+#endif
+
+/******************************************************************************
+ * FUNCTION:        MoveRx
+ *
+ * DESCRIPTION:     Take up to `limit' chars from the rx queue of srcUart and
+ *                  queue them for dstUart, transformed as the two UARTs are
+ *                  configured.
+ *
+ * RETURNS:         The number of chars taken from the rx queue.
+ ***/
+static inline uint32_t MoveRx(const uart_t* srcUart, const uart_t* dstUart,
+  uint32_t limit, bool echoEnabled)
+{
+#ifdef CONFIG_UART_COMPRESS
+  if (NULL != srcUart->compressor) {
+    return CompressRx(srcUart->port, dstUart->port, srcUart->compressor, limit,
+      echoEnabled);
+  }
+#endif
+#ifdef CONFIG_UART_ARQ
+  if (NULL != dstUart->arq) {
+    return ArqFrameRx(srcUart->port, dstUart->port, dstUart->link,
+      dstUart->arq, limit, echoEnabled);
+  }
+  if (NULL != srcUart->arq) {
+    return ArqDeframeRx(srcUart->port, dstUart->port, srcUart->link,
+      srcUart->arq, limit);
+  }
+#endif
+#ifdef CONFIG_UART_FRAMED
+  if (NULL != dstUart->link) {
+    return FrameRx(srcUart->port, dstUart->port, dstUart->link, limit,
+      echoEnabled);
+  }
+  if (NULL != srcUart->link) {
+    return DeframeRx(srcUart->port, dstUart->port, srcUart->link, limit);
+  }
+#endif
+
+  return CopyRx(srcUart->port, dstUart->port, limit, echoEnabled);
+}
+
+#ifdef CONFIG_UART_TAP
+/******************************************************************************
+ * FUNCTION:        TapHeaders
+ *
+ * DESCRIPTION:     Queue the header of a record, after an epoch record if the
+ *                  upper half of the timebase has changed since the last one.
+ *                  The caller has checked for room for both.
+ *
+ * ARGUMENTS:       tag: The tag of the record.
+ *                  stamp: The low half of the timebase when it was read.
+ *                  now: The full timebase, read after `stamp'.
+ ***/
+static void TapHeaders(uint8_t tag, uint32_t stamp, uint64_t now)
+{
+  uint8_t header[TAP_HEADER_SIZE];
+
+  // The stamp is much less than a wrap of the low half old, so the upper half
+  // of it can be recovered from the current time.
+  const uint32_t epoch = (uint32_t)(
+    (now - (uint32_t)((uint32_t)now - stamp)) >> 32);
+  if (!g_tap.epochSent || epoch != g_tap.epoch) {
+    RingPushBulk(&g_tap.ring, header, TapHeader(header, TAP_EPOCH, epoch));
+    g_tap.epoch = epoch;
+    g_tap.epochSent = true;
+  }
+
+  RingPushBulk(&g_tap.ring, header, TapHeader(header, tag, stamp));
+}
+
+/******************************************************************************
+ * FUNCTION:        TapRun
+ *
+ * DESCRIPTION:     Queue the records for one run of chars read from a UART.
+ *                  If the tap has fallen behind, the run is dropped and
+ *                  counted instead, so that it never holds up forwarding.
+ *
+ * ARGUMENTS:       uart: The UART the run was read from.
+ *                  mark: The end of the run.
+ *                  now: The full timebase, read after the mark was made.
+ ***/
+static void TapRun(const uart_t* uart, const tap_mark_t* mark, uint64_t now)
+{
+  port_t* port = uart->port;
+  tap_t* tap = &port->tap;
+  const uint8_t direction = uart->upstream ? 0 : TAP_FROM_TARGET;
+
+  while ((int32_t)(mark->head - tap->position) > 0) {
+    uint32_t length = mark->head - tap->position;
+    length = length < TAP_MAX_RUN ? length : TAP_MAX_RUN;
+    if (RingSpace(&g_tap.ring) < 2 * TAP_HEADER_SIZE + length) {
+      g_tap.dropped += length;
+      tap->position += length;
+      continue;
+    }
+
+    TapHeaders(direction | (uint8_t)length, mark->stamp, now);
+    for (uint32_t copied = 0; copied < length;) {
+      const uint8_t* span = NULL;
+      uint32_t count = RingPeekSpan(&port->rx,
+        tap->position + copied - port->rx.tail, &span);
+      count = count < length - copied ? count : length - copied;
+      RingPushBulk(&g_tap.ring, span, count);
+      copied += count;
+    }
+
+    g_tap.records++;
+    g_tap.bytes += length;
+    tap->position += length;
+  }
+}
+
+#ifdef CONFIG_UART_PRIORITY
+/******************************************************************************
+ * FUNCTION:        TapPriorities
+ *
+ * DESCRIPTION:     Queue a record of one char for each priority char read
+ *                  from a UART, up to `end'.
+ *
+ * ARGUMENTS:       uart: The UART the chars were read from.
+ *                  end: priorityHead of its tap, read before `now'.
+ *                  now: The full timebase.
+ ***/
+static void TapPriorities(const uart_t* uart, uint32_t end, uint64_t now)
+{
+  tap_t* tap = &uart->port->tap;
+  const uint8_t direction = uart->upstream ? 0 : TAP_FROM_TARGET;
+
+  for (; tap->priorityTail != end; tap->priorityTail++) {
+    const tap_priority_t* priority =
+      &tap->priority[tap->priorityTail & (TAP_MARKS - 1)];
+    if (RingSpace(&g_tap.ring) < 2 * TAP_HEADER_SIZE + 1) {
+      g_tap.dropped++;
+      continue;
+    }
+
+    TapHeaders(direction | 1, priority->stamp, now);
+    RingPush(&g_tap.ring, priority->c);
+    g_tap.records++;
+    g_tap.bytes++;
+  }
+}
+#endif
+
+/******************************************************************************
+ * FUNCTION:        TapCapture
+ *
+ * DESCRIPTION:     Bottom half of the tap. Queue records for every run marked
+ *                  by the top halves so far, from both ports in the order
+ *                  they were read. Runs must be captured before they can be
+ *                  forwarded (see ForwardPort), so this runs first. Priority
+ *                  chars were sent as they were read, so they are captured
+ *                  ahead of the runs.
+ ***/
+static void TapCapture(void)
+{
+  tap_t* tap0 = &port0.tap;
+  tap_t* tap1 = &port1.tap;
+  const uint32_t head0 = port0.rx.head;
+  const uint32_t head1 = port1.rx.head;
+  RING_BARRIER();
+  const uint32_t end0 = tap0->markHead;
+  const uint32_t end1 = tap1->markHead;
+#ifdef CONFIG_UART_PRIORITY
+  const uint32_t priorityEnd0 = tap0->priorityHead;
+  const uint32_t priorityEnd1 = tap1->priorityHead;
+#endif
+  RING_BARRIER();
+  const uint64_t now = TimebaseNow64();
+
+#ifdef CONFIG_UART_PRIORITY
+  TapPriorities(&uart0, priorityEnd0, now);
+  TapPriorities(&uart1, priorityEnd1, now);
+#endif
+
+  while (tap0->markTail != end0 || tap1->markTail != end1) {
+    const tap_mark_t* mark0 = &tap0->marks[tap0->markTail & (TAP_MARKS - 1)];
+    const tap_mark_t* mark1 = &tap1->marks[tap1->markTail & (TAP_MARKS - 1)];
+    if (tap1->markTail == end1 || (tap0->markTail != end0
+        && (int32_t)(mark0->stamp - mark1->stamp) <= 0)) {
+      TapRun(&uart0, mark0, now);
+      tap0->markTail++;
+    } else {
+      TapRun(&uart1, mark1, now);
+      tap1->markTail++;
+    }
+  }
+
+  // Runs that found no room for a mark are captured late, as of now.
+  const tap_mark_t late0 = { .stamp = (uint32_t)now, .head = head0 };
+  const tap_mark_t late1 = { .stamp = (uint32_t)now, .head = head1 };
+  TapRun(&uart0, &late0, now);
+  TapRun(&uart1, &late1, now);
+}
+
+/******************************************************************************
+ * FUNCTION:        TapUARTHandler
+ *
+ * DESCRIPTION:     Handle interrupts from the tap's UART: keep its TX FIFO
+ *                  filled from the tap's queue.
+ ***/
+void TapUARTHandler(void) {
+  TRACE_ENTER(TRACE_TAP);
+  PortIntClear(uartTap.uartBase, PortIntStatus(uartTap.uartBase, true));
+  FillFromRing(&uartTap, &g_tap.ring);
+  TRACE_EXIT(TRACE_TAP);
+}
+#endif
+
+/******************************************************************************
+ * FUNCTION:        ForwardPort
+ *
+ * DESCRIPTION:     Bottom half of the forwarding path. Move queued chars from
+ *                  the rx queue of srcUart to the tx queue of dstUart. If
+ *                  echo is enabled on srcUart, also copy them to its echo
+ *                  queue. Data is left in the rx queue when either
+ *                  destination is full; the top half will pend us again once
+ *                  it drains, so echo is never lossy. If coalescing is enabled
+ *                  on srcUart, only the chars it releases are forwarded, and
+ *                  with the tap, only the chars it has captured. See MoveRx
+ *                  for compression, framing and ARQ.
+ *
+ * ARGUMENTS:       srcUart: The UART to copy chars from
+ *                  dstUart: The UART to copy chars to
+ ***/
+static void ForwardPort(const uart_t* srcUart, const uart_t* dstUart)
+{
+  port_t* src = srcUart->port;
+  port_t* dst = dstUart->port;
+
+  // Sampled once, so that a change made mid-run applies to whole spans. The
+  // sender on a framed link only ever expects frames back.
+#ifdef CONFIG_UART_FRAMED
+  const bool echoEnabled = src->echoEnabled && NULL == srcUart->link;
+#else
+  const bool echoEnabled = src->echoEnabled;
+#endif
+
+  uint32_t limit = UINT32_MAX;
+#ifdef CONFIG_UART_COALESCE
+  const bool coalesce = src->coalesce.enabled;
+  if (coalesce && 0 == (limit = CoalesceRelease(srcUart))) {
+    return;
+  }
+#endif
+#ifdef CONFIG_UART_TAP
+  const uint32_t captured = src->tap.position - src->rx.tail;
+  limit = limit < captured ? limit : captured;
+#endif
+
+  const uint32_t txBytes = dst->stats.txBytes;
+  const uint32_t total = MoveRx(srcUart, dstUart, limit, echoEnabled);
+
+#ifdef CONFIG_UART_COALESCE
+  if (coalesce) {
+    CoalesceForwarded(src, total);
+  }
+#endif
+
+  src->stats.rxBytes += total;
+  TRACE_FORWARD(srcUart->traceSource, total);
+  if (echoEnabled) {
+    src->stats.echoBytes += total;
+  }
+
+  // Kick the destination's top half to start filling its TX FIFO. In polling
+  // mode, the main loop fills it instead. Output may be queued without any
+  // new input when the compressor is flushed, and input may produce no output
+  // when it's only part of a frame.
+  if (!IsPolling()) {
+    if (dst->stats.txBytes != txBytes) {
+      IntPendSet(dstUart->intNum);
+    }
+    if (echoEnabled && 0 < total) {
+      IntPendSet(srcUart->intNum);
+    }
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:        PendSVHandler
+ *
+ * DESCRIPTION:     Bottom half of the UART interrupts. Runs at the lowest
+ *                  priority whenever a top half has moved data.
+ ***/
+void PendSVHandler(void) {
+  MARKER_HIGH(MARKER_BOTTOM_HALF);
+  TRACE_ENTER(TRACE_BOTTOM_HALF);
+#ifdef CONFIG_UART_TAP
+  TapCapture();
+#endif
+  ForwardPort(&uart0, &uart1);
+  ForwardPort(&uart1, &uart0);
+#ifdef CONFIG_UART_TAP
+  if (0 < RingCount(&g_tap.ring)) {
+    IntPendSet(uartTap.intNum);
+  }
+#endif
+  TRACE_EXIT(TRACE_BOTTOM_HALF);
+  MARKER_LOW(MARKER_BOTTOM_HALF);
+}
+
+#if defined(CONFIG_UART_POLL) || defined(CONFIG_UART_HYBRID)
+// Worst-case time around the polling loop, in CPU cycles. This bounds the
+// latency added by the firmware to each forwarded character.
+volatile uint32_t g_pollLoopMaxCycles;
+
+/******************************************************************************
+ * FUNCTION:        PollRx
+ *
+ * DESCRIPTION:     Drain the RX FIFO of the UART from the polling loop. The
+ *                  interrupts are masked, so line conditions are taken from
+ *                  the raw interrupt status.
+ *
+ * ARGUMENTS:       uart: The UART to drain.
+ *                  dstUart: The UART that chars from `uart' are routed to.
+ *
+ * RETURNS:         The number of characters read from the FIFO.
+ ***/
+static inline uint32_t PollRx(const uart_t* uart, const uart_t* dstUart)
+{
+  uint32_t status = PortIntStatus(uart->uartBase, false)
+    & UART_LINE_ERROR_INTS;
+  if (status) {
+    PortIntClear(uart->uartBase, status);
+  }
+
+  MARKER_HIGH(MARKER_RX);
+  const uint32_t received = ServiceRx(uart, dstUart, status);
+  MARKER_LOW(MARKER_RX);
+  TRACE_RX(uart->traceSource, received);
+#ifdef CONFIG_UART_TAP
+  TapMark(uart->port);
+#endif
+  return received;
+}
+
+/******************************************************************************
+ * FUNCTION:        PollPorts
+ *
+ * DESCRIPTION:     One pass of the polling loop: both halves of the forwarding
+ *                  path for every port, run from main() with the UART
+ *                  interrupts disabled.
+ *
+ * RETURNS:         The number of characters received during this pass.
+ ***/
+static inline uint32_t PollPorts(void)
+{
+  uint32_t received = PollRx(&uart0, &uart1) + PollRx(&uart1, &uart0);
+#ifdef CONFIG_UART_TAP
+  TapCapture();
+#endif
+  ForwardPort(&uart0, &uart1);
+  ForwardPort(&uart1, &uart0);
+  FillTxFifo(&uart0);
+  FillTxFifo(&uart1);
+#ifdef CONFIG_UART_TAP
+  FillFromRing(&uartTap, &g_tap.ring);
+#endif
+#ifdef CONFIG_UART_RS485
+  const uint32_t now = CyclesNow();
+  if (uart0.halfDuplex) {
+    ReleaseDriver(&uart0, now);
+  }
+  if (uart1.halfDuplex) {
+    ReleaseDriver(&uart1, now);
+  }
+#endif
+  return received;
+}
+#endif
+
+#ifdef CONFIG_UART_HYBRID
+/******************************************************************************
+ * FUNCTION:        PollUntilIdle
+ *
+ * DESCRIPTION:     Run the polling loop until neither port has received
+ *                  anything for CONFIG_UART_HYBRID_IDLE_CHARS character times
+ *                  and everything queued has been handed to the TX FIFOs,
+ *                  then switch back to interrupts.
+ *
+ * ARGUMENTS:       idleCycles: The idle period, in CPU cycles.
+ ***/
+static void PollUntilIdle(uint32_t idleCycles)
+{
+  uint32_t last = CyclesNow();
+  uint32_t lastActive = last;
+
+  IntMasterDisable();
+  while (CyclesNow() - lastActive < idleCycles
+    || 0 < RingCount(&port0.tx) || 0 < RingCount(&port1.tx)
+    || 0 < RingCount(&port0.echo) || 0 < RingCount(&port1.echo)) {
+    if (0 < PollPorts()) {
+      lastActive = CyclesNow();
+    }
+
+    uint32_t now = CyclesNow();
+    if (now - last > g_pollLoopMaxCycles) {
+      g_pollLoopMaxCycles = now - last;
+    }
+    last = now;
+
+    // Let anything else that's pending run between passes.
+    IntMasterEnable();
+    IntMasterDisable();
+  }
+
+  ExitPollMode();
+  IntMasterEnable();
+}
+#endif
+
+#ifdef CONFIG_UART_BERT
+// The ports by number, as named in g_bert, and those under test while it
+// runs.
+static const uart_t* const bertUarts[] = { &uart0, &uart1 };
+static const uart_t* g_bertTx;
+static const uart_t* g_bertRx;
+
+/******************************************************************************
+ * FUNCTION:        GenericBertHandler
+ *
+ * DESCRIPTION:     Replaces the top half of both UARTs while the tester runs.
+ *                  Checks every char received on the port under test, and
+ *                  keeps the TX FIFO of the sending port full of the pattern.
+ *                  Chars received on any other port are dropped.
+ *
+ * ARGUMENTS:       uart: The UART that raised the interrupt.
+ ***/
+PORT_INLINE void GenericBertHandler(const uart_t* uart)
+{
+  const uint32_t base = uart->uartBase;
+  uint32_t status = PortIntStatus(base, true);
+  PortIntClear(base, status);
+
+  if (uart == g_bertRx) {
+    if (status & UART_INT_OE) {
+      g_bert.overruns++;
+    }
+
+    while (PortCharsAvail(base)) {
+      const uint32_t c = PortCharGet(base);
+      if (c & UART_DR_BE) {
+        g_bert.breaks++;
+        continue;
+      } else if (c & UART_DR_FE) {
+        g_bert.framingErrors++;
+      }
+      PrbsCheck(&g_bert.checker, (uint8_t)c);
+    }
+  } else {
+    while (PortCharsAvail(base)) {
+      PortCharGet(base);
+    }
+  }
+
+  if (uart == g_bertTx) {
+    while (PortSpaceAvail(base)) {
+      HWREG(base + UART_O_DR) = PrbsNext(&g_bert.generator);
+      g_bert.charsSent++;
+    }
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:        BertZeroHandler, BertOneHandler
+ *
+ * DESCRIPTION:     Handle interrupts from each port's UART while the tester
+ *                  runs.
+ ***/
+BRIDGE_PORTS(PORT_BERT_HANDLER)
+
+/******************************************************************************
+ * FUNCTION:        BertSetBaudRate
+ *
+ * DESCRIPTION:     Reprogram the baud rate of a UART, keeping its framing.
+ *                  The FIFO levels and interrupt mask survive this.
+ ***/
+static void BertSetBaudRate(const uart_t* uart, uint32_t baudRate)
+{
+  UARTConfigSetExpClk(uart->uartBase, ROM_SysCtlClockGet(), baudRate,
+    uart->config);
+}
 
-} uart_t;
+/******************************************************************************
+ * FUNCTION:        BertStop
+ *
+ * DESCRIPTION:     End the test, and give both UARTs back to the bridge at
+ *                  its baud rate. The statistics are left for reading.
+ ***/
+static void BertStop(void)
+{
+  if (!g_bert.running) {
+    return;
+  }
 
-void UARTZeroHandler(void);
-void UARTOneHandler(void);
+  for (uint32_t i = 0; i < 2; ++i) {
+    IntDisable(bertUarts[i]->intNum);
+  }
 
-// Parameters for UART0
-static const uart_t uart0 = {
-  .hostGpio = SYSCTL_PERIPH_GPIOA,
-  .hostUart = SYSCTL_PERIPH_UART0,
-  .rxPin = GPIO_PA0_U0RX,
-  .txPin = GPIO_PA1_U0TX,
-  .gpioBase = GPIO_PORTA_BASE,
-  .gpioPins = GPIO_PIN_0 | GPIO_PIN_1,
-  .uartBase = UART0_BASE,
-  .baudRate = CONFIG_UART_BAUDRATE,
-  .config = (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE
-    | UART_CONFIG_PAR_NONE),
-  .intHandler = UARTZeroHandler,
-  .intMask = (UART_INT_RX | UART_INT_RT),
-};
+  HWREG(g_bertTx->uartBase + UART_O_CTL) &= ~UART_CTL_LBE;
+#ifdef CONFIG_UART_RS485
+  if (g_bertTx->halfDuplex) {
+    SetDriverEnable(g_bertTx, false);
+  }
+#endif
+  if (0 != g_bert.baudRate) {
+    BertSetBaudRate(g_bertTx, g_bertTx->baudRate);
+    BertSetBaudRate(g_bertRx, g_bertRx->baudRate);
+  }
 
-// Parameters for UART1
-static const uart_t uart1 = {
-  .hostGpio = SYSCTL_PERIPH_GPIOB,
-  .hostUart = SYSCTL_PERIPH_UART1,
-  .rxPin = GPIO_PB0_U1RX,
-  .txPin = GPIO_PB1_U1TX,
-  .gpioBase = GPIO_PORTB_BASE,
-  .gpioPins = GPIO_PIN_0 | GPIO_PIN_1,
-  .uartBase = UART1_BASE,
-  .baudRate = CONFIG_UART_BAUDRATE,
-  .config = (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE
-    | UART_CONFIG_PAR_NONE),
-  .intHandler = UARTOneHandler,
-  .intMask = (UART_INT_RX | UART_INT_RT),
-};
+  g_bert.running = false;
+  g_bertTx = NULL;
+  g_bertRx = NULL;
+  TRACE_MODE(TRACE_MODE_INTERRUPT);
+
+  // Pending the top halves restarts anything the bridge had queued.
+  for (uint32_t i = 0; i < 2; ++i) {
+    UARTIntRegister(bertUarts[i]->uartBase, bertUarts[i]->intHandler);
+    IntPendSet(bertUarts[i]->intNum);
+  }
+}
 
 /******************************************************************************
- * FUNCTIONS
+ * FUNCTION:        BertStart
+ *
+ * DESCRIPTION:     Start a test with the settings in g_bert, clearing its
+ *                  statistics. The bridge is paused on both ports until the
+ *                  test is stopped. Nothing is started if the settings are
+ *                  invalid.
  ***/
+static void BertStart(void)
+{
+  BertStop();
+  if (g_bert.txPort > 1 || g_bert.rxPort > 1
+    || !PrbsInit(&g_bert.generator, g_bert.pattern)
+    || !PrbsCheckerInit(&g_bert.checker, g_bert.pattern)) {
+    return;
+  }
+
+  g_bert.charsSent = 0;
+  g_bert.framingErrors = 0;
+  g_bert.overruns = 0;
+  g_bert.breaks = 0;
+
+  for (uint32_t i = 0; i < 2; ++i) {
+    IntDisable(bertUarts[i]->intNum);
+  }
+
+  g_bertTx = bertUarts[g_bert.txPort];
+  g_bertRx = g_bert.loopback ? g_bertTx : bertUarts[g_bert.rxPort];
+  if (0 != g_bert.baudRate) {
+    BertSetBaudRate(g_bertTx, g_bert.baudRate);
+    BertSetBaudRate(g_bertRx, g_bert.baudRate);
+  }
+  if (g_bert.loopback) {
+    UARTLoopbackEnable(g_bertTx->uartBase);
+  }
+#ifdef CONFIG_UART_RS485
+  else if (g_bertTx->halfDuplex) {
+    SetDriverEnable(g_bertTx, true);
+  }
+#endif
+
+  g_bert.running = true;
+  TRACE_MODE(TRACE_MODE_BERT);
+
+  // The TX interrupt only fires as the FIFO drains past its level, so the
+  // first fill is done by pending it.
+  for (uint32_t i = 0; i < 2; ++i) {
+    UARTIntRegister(bertUarts[i]->uartBase, i ? BertOneHandler
+      : BertZeroHandler);
+  }
+  IntPendSet(g_bertTx->intNum);
+}
 
 /******************************************************************************
- * FUNCTION:        GenericUARTIntHandler
+ * FUNCTION:        BertService
  *
- * DESCRIPTION:     Handle an interrupt from one of the UARTs. Copy chars from
- *                  the srcUart FIFO to the dstUart FIFO. If `echo' is set,
- *                  echo the characters back to the srcUart.
- *
- * ARGUMENTS:       srcUart: Base address of the UART to copy chars from
- *                  dstUart: Base address of the UART to copy chars to
- *                  echo: bool switch--echo chars back to src if true.
+ * DESCRIPTION:     Carry out a command written to g_bert.command.
  ***/
-static inline void GenericUARTIntHandler(const uart_t* srcUart,
-  const uart_t* dstUart)
+static void BertService(void)
 {
-  // Clear interrupt status
-  UARTIntClear(srcUart->uartBase, srcUart->intMask);
-
-  // Copy data from srcUart to destUart
-  int32_t c = 0;
-  while (UARTCharsAvail(srcUart->uartBase)) {
-    // Peripheral Driver Library Documentation, Section 30.2.2.8, Return:
-    //   "The UARTCharsAvail() function should be called before attempting to
-    //    call this function."
-    if (-1 == (c = UARTCharGetNonBlocking(srcUart->uartBase))) {
-      return;
-    }
+  const uint32_t command = g_bert.command;
+  if (0 == command) {
+    return;
+  }
 
-    UARTCharPutNonBlocking(dstUart->uartBase, c);
-#ifdef CONFIG_UART_ECHO
-    UARTCharPutNonBlocking(srcUart->uartBase, c);
-#endif
+  if (BERT_START == command) {
+    BertStart();
+  } else if (BERT_STOP == command) {
+    BertStop();
   }
+  g_bert.command = 0;
 }
+#endif
 
 /******************************************************************************
- * FUNCTION:        UARTZeroHandler
+ * FUNCTION:        PowerUARTPeripherals
+ *
+ * DESCRIPTION:     Turn on the clocks of all of the peripherals a UART uses
+ *                  (its GPIO port, the UART itself, its timers and its
+ *                  driver-enable GPIO) at once, by writing their clock gates
+ *                  directly, the way SysCtlPeripheralEnable() does. They then
+ *                  power up together, instead of one ROM call at a time.
  *
- * DESCRIPTION:     Handle interrupts from UART0.
+ * ARGUMENTS:       uart: The UART.
+ *                  wait: Whether to wait until all of them are ready.
  ***/
-void UARTZeroHandler(void) {
-  GenericUARTIntHandler(&uart0, &uart1);
+static void PowerUARTPeripherals(const uart_t* uart, bool wait)
+{
+  const uint32_t periphs[] = {
+    uart->hostGpio,
+    uart->hostUart,
+    uart->breakTimer.periph,
+#ifdef CONFIG_UART_COALESCE
+    uart->coalesceTimer.periph,
+#endif
+#ifdef CONFIG_UART_GAP
+    uart->gapTimer.periph,
+#endif
+#ifdef CONFIG_UART_RS485
+    uart->halfDuplex ? uart->dePeriph : 0,
+#endif
+  };
+
+  // Unused timers (the tap's) are left zero.
+  for (uint32_t i = 0; i < sizeof(periphs) / sizeof(*periphs); ++i) {
+    if (0 != periphs[i]) {
+      HWREGBITW(SYSCTL_RCGCBASE + PERIPH_REG(periphs[i]),
+        PERIPH_BIT(periphs[i])) = 1;
+    }
+  }
+
+  for (uint32_t i = 0; wait && i < sizeof(periphs) / sizeof(*periphs); ++i) {
+    if (0 != periphs[i]) {
+      while (!HWREGBITW(SYSCTL_PRBASE + PERIPH_REG(periphs[i]),
+          PERIPH_BIT(periphs[i]))) {
+        // A few cycles at most, for all of them together.
+      }
+    }
+  }
 }
 
 /******************************************************************************
- * FUNCTION:        UARTOneHandler
+ * FUNCTION:        ConfigureTimer
  *
- * DESCRIPTION:     Handle interrupts from UART1.
+ * DESCRIPTION:     Configure a port's timer and register its handler. The
+ *                  timer is left stopped. Its interrupt shares the UARTs'
+ *                  priority group, so it never preempts (or is preempted by)
+ *                  a top half.
+ *
+ * ARGUMENTS:       timer: The timer to configure.
+ *                  config: TIMER_CFG_* mode of the timer.
  ***/
-void UARTOneHandler(void) {
-  GenericUARTIntHandler(&uart1, &uart0);
+static void ConfigureTimer(const hwtimer_t* timer, uint32_t config)
+{
+  ROM_TimerConfigure(timer->base, config);
+  ROM_TimerIntEnable(timer->base, TIMER_TIMA_TIMEOUT);
+  ROM_IntPrioritySet(timer->intNum, TIMER_INT_PRIORITY);
+  TimerIntRegister(timer->base, TIMER_A, timer->handler);
 }
 
 /******************************************************************************
@@ -145,34 +2727,545 @@ void UARTOneHandler(void) {
  ***/
 static void ConfigureUART(const uart_t* uart)
 {
-  // Enable the GPIO Peripheral used by the UART.
-  ROM_SysCtlPeripheralEnable(uart->hostGpio);
+  // The queues must be usable before the first interrupt arrives. In gap
+  // mode, the rx queue is shortened to match the timestamps.
+#ifdef CONFIG_UART_GAP
+  RingInit(&uart->port->rx, uart->port->rxStorage, CONFIG_UART_GAP_DEPTH);
+#else
+  RingInit(&uart->port->rx, uart->port->rxStorage,
+    sizeof(uart->port->rxStorage));
+#endif
+  RingInit(&uart->port->tx, uart->port->txStorage,
+    sizeof(uart->port->txStorage));
+  RingInit(&uart->port->echo, uart->port->echoStorage,
+    sizeof(uart->port->echoStorage));
+  uart->port->echoEnabled = UART_ECHO_DEFAULT;
+#ifdef CONFIG_UART_COMPRESS
+  if (NULL != uart->compressor) {
+    LzInit(uart->compressor);
+  }
+#endif
+#ifdef CONFIG_UART_FRAMED
+  if (NULL != uart->link) {
+    FrameInit(uart->link);
+  }
+#endif
+#ifdef CONFIG_UART_ARQ
+  // A window takes ARQ_WINDOW full frames to send, after up to a full tx
+  // queue, and its ACKs can be as far behind.
+  if (NULL != uart->arq) {
+    const uint32_t charCycles = ROM_SysCtlClockGet() / (uart->baudRate / 10);
+    ArqInit(uart->arq, charCycles * (CONFIG_UART_RING_SIZE
+        + ARQ_WINDOW * (FRAME_MAX_PAYLOAD + 2 * FRAME_CRC_SIZE))
+      + CONFIG_UART_ARQ_LATENCY_US * (ROM_SysCtlClockGet() / 1000000));
+  }
+#endif
+#ifdef CONFIG_UART_PRIORITY
+  RingInit(&uart->port->prio, uart->port->prioStorage,
+    sizeof(uart->port->prioStorage));
+
+  // Only chars typed on the host side are treated as priority chars. Traffic
+  // from the target may be binary, and must never be reordered. Neither may
+  // the bytes of a frame.
+#ifdef CONFIG_UART_FRAMED
+  if (uart->upstream && NULL == uart->link) {
+#else
+  if (uart->upstream) {
+#endif
+    static const uint8_t priorityChars[] = { CONFIG_UART_PRIORITY_CHARS };
+    for (uint32_t i = 0; i < sizeof(priorityChars); ++i) {
+      uart->port->priorityMap[priorityChars[i] >> 5] |=
+        1u << (priorityChars[i] & 31);
+    }
+  }
+#endif
 
-  // Enable UART0
-  ROM_SysCtlPeripheralEnable(uart->hostUart);
+  // Enable the GPIO port, the UART and its timers, if main() hasn't already.
+  PowerUARTPeripherals(uart, true);
 
   // Configure GPIO Pins for UART mode.
   ROM_GPIOPinConfigure(uart->rxPin);
   ROM_GPIOPinConfigure(uart->txPin);
   ROM_GPIOPinTypeUART(uart->gpioBase, uart->gpioPins);
 
+#ifdef CONFIG_UART_RS485
+  // The driver must be off before the UART is enabled.
+  if (uart->halfDuplex) {
+    HWREG(SYSCTL_GPIOHBCTL) |= uart->deAhbPort;
+    ROM_GPIOPinTypeGPIOOutput(uart->deGpioBase, uart->dePin);
+    SetDriverEnable(uart, false);
+  }
+#endif
+
   // Run the peripheral from the PLL
-  UARTClockSourceSet(uart->uartBase, UART_CLOCK_SYSTEM);
+  ROM_UARTClockSourceSet(uart->uartBase, UART_CLOCK_SYSTEM);
 
   // Configure the UART's mode
-  UARTConfigSetExpClk(uart->uartBase, ROM_SysCtlClockGet(), uart->baudRate,
-    uart->config);
+  ROM_UARTConfigSetExpClk(uart->uartBase, ROM_SysCtlClockGet(),
+    uart->baudRate, uart->config);
+
+#ifdef CONFIG_UART_MULTIDROP
+  // Data chars are sent with the 9th bit clear. The address must be set
+  // first, since UART9BitAddrSet overwrites the enable bit.
+  if (uart->multidrop) {
+    UARTParityModeSet(uart->uartBase, UART_CONFIG_PAR_ZERO);
+    UART9BitAddrSet(uart->uartBase, CONFIG_UART_MULTIDROP_ADDR,
+      CONFIG_UART_MULTIDROP_MASK);
+    UART9BitEnable(uart->uartBase);
+  }
+#endif
+
+  // The break timer ticks once per character time while a break is being
+  // forwarded from this UART.
+  ConfigureTimer(&uart->breakTimer, TIMER_CFG_PERIODIC);
+  ROM_TimerLoadSet(uart->breakTimer.base, TIMER_A,
+    ROM_SysCtlClockGet() / (uart->baudRate / 10));
+
+#ifdef CONFIG_UART_COALESCE
+  // Only traffic headed for the host is coalesced by default.
+  coalesce_t* coalesce = &uart->port->coalesce;
+  coalesce->enabled = !uart->upstream;
+  coalesce->delimiter = CONFIG_UART_COALESCE_DELIMITER;
+  coalesce->size = CONFIG_UART_COALESCE_SIZE;
+  coalesce->timeoutUs = CONFIG_UART_COALESCE_TIMEOUT_US;
+  coalesce->maxUs = CONFIG_UART_COALESCE_MAX_US;
+  coalesce->cyclesPerUs = ROM_SysCtlClockGet() / 1000000;
+  ConfigureTimer(&uart->coalesceTimer, TIMER_CFG_ONE_SHOT);
+#endif
 
-  // Set the FIFO Level at which interrupts are generated
-  UARTFIFOLevelSet(uart->uartBase, 0, UART_FIFO_RX6_8);
+#ifdef CONFIG_UART_GAP
+  // Each char must be seen (and stamped) as it arrives, so run without the
+  // FIFOs: every received char raises the RX interrupt.
+  const uint32_t bitCycles = ROM_SysCtlClockGet() / uart->baudRate;
+  uart->port->gap.delay = CONFIG_UART_GAP_DELAY_BITS * bitCycles;
+  uart->port->gap.frameGap = CONFIG_UART_GAP_FRAME_BITS * bitCycles;
+  ConfigureTimer(&uart->gapTimer, TIMER_CFG_ONE_SHOT);
+  UARTFIFODisable(uart->uartBase);
+#else
+  // Set the FIFO Level at which interrupts are generated. The TX level leaves
+  // a few characters in the FIFO to cover our interrupt latency.
+  ROM_UARTFIFOLevelSet(uart->uartBase, UART_FIFO_TX2_8, UART_FIFO_RX6_8);
+#endif
 
+#ifndef CONFIG_UART_POLL
   // Enable interrupts: Must be done before registering interrupt handler.
-  UARTIntEnable(uart->uartBase, uart->intMask);
+  ROM_UARTIntEnable(uart->uartBase, uart->intMask);
 
   // We *could* register the interrupt statically. But this allows the entire
   // application to be confined to only this source file.
+  ROM_IntPrioritySet(uart->intNum, uart->intPriority);
+  UARTIntRegister(uart->uartBase, uart->intHandler);
+#endif
+}
+
+#ifdef CONFIG_UART_TAP
+/******************************************************************************
+ * FUNCTION:        ConfigureTap
+ *
+ * DESCRIPTION:     Configure the tap's UART, which only transmits. Its
+ *                  interrupt runs below the top halves, so that the tap never
+ *                  delays forwarding, but above the bottom half that feeds
+ *                  it.
+ *
+ * ARGUMENTS:       uart: Configuration parameters and addresses of the UART.
+ ***/
+static void ConfigureTap(const uart_t* uart)
+{
+  RingInit(&g_tap.ring, g_tap.storage, sizeof(g_tap.storage));
+
+  PowerUARTPeripherals(uart, true);
+  ROM_GPIOPinConfigure(uart->txPin);
+  ROM_GPIOPinTypeUART(uart->gpioBase, uart->gpioPins);
+
+  ROM_UARTClockSourceSet(uart->uartBase, UART_CLOCK_SYSTEM);
+  ROM_UARTConfigSetExpClk(uart->uartBase, ROM_SysCtlClockGet(),
+    uart->baudRate, uart->config);
+  ROM_UARTFIFOLevelSet(uart->uartBase, UART_FIFO_TX2_8, UART_FIFO_RX6_8);
+
+#ifndef CONFIG_UART_POLL
+  ROM_UARTIntEnable(uart->uartBase, uart->intMask);
+  ROM_IntPrioritySet(uart->intNum, uart->intPriority);
   UARTIntRegister(uart->uartBase, uart->intHandler);
+#endif
+}
+#endif
+
+#ifdef CONFIG_UART_BENCH
+/******************************************************************************
+ * FUNCTION:        BenchProbeHandler
+ *
+ * DESCRIPTION:     Note when the exception path got here, and when it's about
+ *                  to be taken back.
+ ***/
+void BenchProbeHandler(void) {
+  g_probeEntry = CyclesNow();
+  g_probeExit = CyclesNow();
+}
+
+/******************************************************************************
+ * FUNCTION:        ProbeExceptionPath
+ *
+ * DESCRIPTION:     Time the entry into and exit from BenchProbeHandler,
+ *                  pended from here by a store to the software trigger
+ *                  register. The entry includes that store. If `useFpu', the
+ *                  FPU is used before each run, which makes the processor
+ *                  make room for its state on entry, unless startup_gcc.c
+ *                  has told it not to. CONTROL.FPCA is cleared afterwards,
+ *                  so that the bridge isn't left paying for it. Never
+ *                  inlined, so that `make fpucheck' can tell its FPU
+ *                  instruction apart by the function it's in.
+ *
+ * ARGUMENTS:       useFpu: Whether to use the FPU before each run.
+ *                  entryCycles: Set to the fewest cycles taken to enter.
+ *                  exitCycles: Set to the fewest cycles taken to return.
+ ***/
+static __attribute__((noinline)) void ProbeExceptionPath(bool useFpu,
+  uint32_t* entryCycles, uint32_t* exitCycles)
+{
+  const uint32_t first = CyclesNow();
+  const uint32_t overhead = CyclesNow() - first;
+
+  *entryCycles = UINT32_MAX;
+  *exitCycles = UINT32_MAX;
+  for (uint32_t i = 0; i < BENCH_PROBE_RUNS; ++i) {
+    if (useFpu) {
+      __asm volatile ("vmov.f32 s0, s0" : : : "s0");
+    }
+
+    const uint32_t pended = CyclesNow();
+    HWREG(NVIC_SW_TRIG) = BENCH_PROBE_INT - 16;
+    __asm volatile ("dsb\n\tisb" : : : "memory");
+    const uint32_t returned = CyclesNow();
+
+    if (g_probeEntry - pended - overhead < *entryCycles) {
+      *entryCycles = g_probeEntry - pended - overhead;
+    }
+    if (returned - g_probeExit - overhead < *exitCycles) {
+      *exitCycles = returned - g_probeExit - overhead;
+    }
+  }
+
+  if (useFpu) {
+    __asm volatile ("mrs r0, control\n\t"
+                    "bic r0, r0, #4\n\t"
+                    "msr control, r0\n\t"
+                    "isb" : : : "r0", "memory");
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:        RunBench
+ *
+ * DESCRIPTION:     Measure the forwarding path at boot. Each UART is looped
+ *                  back on itself, with its TX pin taken away from it so
+ *                  that nothing leaves the board, and a burst queued on both
+ *                  ports then circulates between them through the top and
+ *                  bottom halves for CONFIG_UART_BENCH_MS. The time spent
+ *                  outside this function's idle loop is the cost of the
+ *                  interrupts. Afterwards the receivers are turned off, so
+ *                  that the queues drain through the normal path, and the
+ *                  ports are given back to the bridge.
+ ***/
+static void RunBench(void)
+{
+  const uart_t* const uarts[] = { &uart0, &uart1 };
+  const uint32_t clock = ROM_SysCtlClockGet();
+  bool echoEnabled[2];
+  uint32_t bytes = 0;
+  uint32_t dropped = 0;
+  uint32_t overruns = 0;
+
+  TRACE_MODE(TRACE_MODE_BENCH);
+
+  IntRegister(BENCH_PROBE_INT, BenchProbeHandler);
+  IntPrioritySet(BENCH_PROBE_INT, UART1_INT_PRIORITY);
+  IntEnable(BENCH_PROBE_INT);
+  ProbeExceptionPath(false, &g_bench.entryCycles, &g_bench.exitCycles);
+  uint32_t fpExit = 0;
+  ProbeExceptionPath(true, &g_bench.entryFpCycles, &fpExit);
+  IntDisable(BENCH_PROBE_INT);
+  IntUnregister(BENCH_PROBE_INT);
+
+  for (uint32_t i = 0; i < 2; ++i) {
+    const uart_t* uart = uarts[i];
+    port_t* port = uart->port;
+    echoEnabled[i] = port->echoEnabled;
+    port->echoEnabled = false;
+    ROM_GPIOPinTypeGPIOInput(uart->gpioBase,
+      uart->gpioPins & ~uart->rxGpioPin);
+    UARTLoopbackEnable(uart->uartBase);
+
+    // Printable chars, so that none of them are priority chars.
+    for (uint32_t j = 0; j < BENCH_BURST; ++j) {
+      RingPush(&port->tx, (uint8_t)(' ' + j % 95));
+    }
+  }
+
+  uint32_t topHalf = g_topHalfCycles;
+  for (uint32_t i = 0; i < 2; ++i) {
+    bytes -= uarts[i]->port->stats.rxBytes;
+    dropped -= uarts[i]->port->stats.rxDropped;
+    overruns -= uarts[i]->port->stats.overruns;
+    IntPendSet(uarts[i]->intNum);
+  }
+
+  const uint32_t duration = CONFIG_UART_BENCH_MS * (clock / 1000);
+  const uint32_t start = CyclesNow();
+  uint32_t last = start;
+  uint32_t idle = 0;
+  while (last - start < duration) {
+    const uint32_t now = CyclesNow();
+    if (now - last < BENCH_IDLE_GAP) {
+      idle += now - last;
+    }
+    last = now;
+  }
+
+  topHalf = g_topHalfCycles - topHalf;
+  for (uint32_t i = 0; i < 2; ++i) {
+    bytes += uarts[i]->port->stats.rxBytes;
+    dropped += uarts[i]->port->stats.rxDropped;
+    overruns += uarts[i]->port->stats.overruns;
+    HWREG(uarts[i]->uartBase + UART_O_CTL) &= ~UART_CTL_RXE;
+  }
+
+  const uint32_t elapsed = last - start;
+  g_bench.clockHz = clock;
+  g_bench.baudRate = CONFIG_UART_BAUDRATE;
+  g_bench.cycles = elapsed;
+  g_bench.bytes = bytes;
+  g_bench.bytesPerSecond = (uint32_t)((uint64_t)bytes * clock / elapsed);
+  g_bench.topHalfCycles = topHalf;
+  g_bench.busyCycles = elapsed - idle;
+  if (0 < bytes) {
+    g_bench.topHalfCyclesPer100Bytes =
+      (uint32_t)((uint64_t)topHalf * 100 / bytes);
+    g_bench.busyCyclesPer100Bytes =
+      (uint32_t)((uint64_t)(elapsed - idle) * 100 / bytes);
+  }
+  g_bench.dropped = dropped;
+  g_bench.overruns = overruns;
+
+  // With the receivers off, what's queued drains into the void. Chars left
+  // in one port's queues can still be forwarded into the other's.
+  bool draining = true;
+  while (draining) {
+    draining = false;
+    for (uint32_t i = 0; i < 2; ++i) {
+      const uart_t* uart = uarts[i];
+      draining |= 0 < RingCount(&uart->port->rx)
+        || 0 < RingCount(&uart->port->tx)
+        || PortCharsAvail(uart->uartBase) || UARTBusy(uart->uartBase);
+    }
+  }
+
+  for (uint32_t i = 0; i < 2; ++i) {
+    const uart_t* uart = uarts[i];
+    HWREG(uart->uartBase + UART_O_CTL) =
+      (HWREG(uart->uartBase + UART_O_CTL) & ~UART_CTL_LBE) | UART_CTL_RXE;
+    ROM_GPIOPinTypeUART(uart->gpioBase, uart->gpioPins);
+    uart->port->echoEnabled = echoEnabled[i];
+  }
+  g_bench.done = true;
+  TRACE_MODE(TRACE_MODE_INTERRUPT);
+}
+#endif
+
+/******************************************************************************
+ * FUNCTION:        CrashCapture
+ *
+ * DESCRIPTION:     Record a crash in g_crash (see crash.h), then reset. With a
+ *                  debugger attached, stop instead, so that the state can be
+ *                  looked at. Only reads memory that's always there, so that
+ *                  a crash that has trampled .bss can't fault it again.
+ *
+ * ARGUMENTS:       frame: The registers the exception stacked.
+ *                  excReturn: The exception return value (lr on entry).
+ *                  saved: r4-r11, as pushed by the handler.
+ ***/
+__attribute__((used)) void CrashCapture(const uint32_t* frame,
+  uint32_t excReturn, const uint32_t* saved)
+{
+  const port_t* const ports[] = { &port0, &port1 };
+
+  g_crash.count = CrashValid() ? g_crash.count + 1 : 1;
+  g_crash.magic = CRASH_MAGIC;
+  g_crash.exception = HWREG(NVIC_INT_CTRL) & NVIC_INT_CTRL_VEC_ACT_M;
+  g_crash.cycles = CyclesNow();
+  for (uint32_t i = 0; i < 8; ++i) {
+    g_crash.regs[CRASH_R0 + i] = frame[i];
+    g_crash.regs[CRASH_R4 + i] = saved[i];
+  }
+
+  // The frame is 26 words if it holds the FPU's state, and a word of padding
+  // was added above it to align it if bit 9 of the stacked xPSR is set.
+  g_crash.regs[CRASH_SP] = (uint32_t)frame + ((excReturn & 0x10) ? 32 : 104)
+    + ((frame[CRASH_XPSR] & 0x200) ? 4 : 0);
+  g_crash.regs[CRASH_EXC_RETURN] = excReturn;
+  g_crash.regs[CRASH_CFSR] = HWREG(NVIC_FAULT_STAT);
+  g_crash.regs[CRASH_HFSR] = HWREG(NVIC_HFAULT_STAT);
+  g_crash.regs[CRASH_MMFAR] = HWREG(NVIC_MM_ADDR);
+  g_crash.regs[CRASH_BFAR] = HWREG(NVIC_FAULT_ADDR);
+
+  // What's behind the tail of a tx queue has gone to its UART. The storage
+  // is indexed directly, rather than through the ring's own pointer.
+  for (uint32_t i = 0; i < 2; ++i) {
+    const uint32_t tail = ports[i]->tx.tail;
+    const uint32_t count = tail < CRASH_RECENT_CHARS ? tail
+      : CRASH_RECENT_CHARS;
+    g_crash.recentCount[i] = count;
+    for (uint32_t j = 0; j < CRASH_RECENT_CHARS; ++j) {
+      g_crash.recent[i][j] = j < count ? ports[i]->txStorage[
+        (tail - count + j) & (sizeof(ports[i]->txStorage) - 1)] : 0;
+    }
+  }
+  g_crash.checksum = CrashChecksum(&g_crash);
+
+  if (HWREG(NVIC_DBG_CTRL) & NVIC_DBG_CTRL_C_DEBUGEN) {
+    while (1) {
+      // Over to the debugger.
+    }
+  }
+
+  HWREG(NVIC_APINT) = NVIC_APINT_VECTKEY | NVIC_APINT_SYSRESETREQ;
+  while (1) {
+    // The reset takes a few cycles to happen.
+  }
+}
+
+#ifdef CRASH_REPORT
+// The part of the crash report that hasn't been queued yet.
+typedef struct {
+
+  const uart_t* uart;
+  uint32_t length;
+  uint8_t buffer[REPORT_CHUNK];
+
+} report_t;
+
+/******************************************************************************
+ * FUNCTION:        CrashReportRequested
+ *
+ * DESCRIPTION:     Whether SW1 is held down.
+ ***/
+static bool CrashReportRequested(void)
+{
+  ROM_SysCtlPeripheralEnable(REPORT_BUTTON_PERIPH);
+  while (!ROM_SysCtlPeripheralReady(REPORT_BUTTON_PERIPH)) {
+    // The GPIO port takes a few cycles to come out of reset.
+  }
+
+  ROM_GPIOPinTypeGPIOInput(REPORT_BUTTON_BASE, REPORT_BUTTON_PIN);
+  ROM_GPIOPadConfigSet(REPORT_BUTTON_BASE, REPORT_BUTTON_PIN,
+    GPIO_STRENGTH_2MA, GPIO_PIN_TYPE_STD_WPU);
+  // Give the pull-up a few microseconds to bring the pin up.
+  ROM_SysCtlDelay(ROM_SysCtlClockGet() / 300000);
+  return 0 == ROM_GPIOPinRead(REPORT_BUTTON_BASE, REPORT_BUTTON_PIN);
+}
+
+/******************************************************************************
+ * FUNCTION:        ReportFlush
+ *
+ * DESCRIPTION:     Queue what's in the report's buffer for its UART, as a
+ *                  frame if the UART has a framed link. A chunk that doesn't
+ *                  fit in the tx queue is dropped whole, so that a frame is
+ *                  never cut short.
+ ***/
+static void ReportFlush(report_t* report)
+{
+  ringbuf_t* ring = &report->uart->port->tx;
+  const uint8_t* out = report->buffer;
+  uint32_t length = report->length;
+  if (0 == length) {
+    return;
+  }
+
+#ifdef CONFIG_UART_FRAMED
+  uint8_t staging[FRAME_BOUND(REPORT_CHUNK)];
+  if (NULL != report->uart->link) {
+    length = FrameEncode(report->uart->link, out, length, staging);
+    out = staging;
+  }
+#endif
+
+  if (RingSpace(ring) >= length) {
+    RingPushBulk(ring, out, length);
+  }
+  report->length = 0;
+}
+
+/******************************************************************************
+ * FUNCTION:        ReportString
+ *
+ * DESCRIPTION:     Add a string to the report.
+ ***/
+static void ReportString(report_t* report, const char* string)
+{
+  while ('\0' != *string) {
+    if (REPORT_CHUNK == report->length) {
+      ReportFlush(report);
+    }
+    report->buffer[report->length++] = (uint8_t)*string++;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:        ReportHex
+ *
+ * DESCRIPTION:     Add the `digits' low hex digits of `value' to the report.
+ ***/
+static void ReportHex(report_t* report, uint32_t value, uint32_t digits)
+{
+  char hex[9] = {0};
+  for (uint32_t i = 0; i < digits; ++i) {
+    hex[i] = "0123456789abcdef"[(value >> (4 * (digits - 1 - i))) & 0xf];
+  }
+  ReportString(report, hex);
+}
+
+/******************************************************************************
+ * FUNCTION:        ReportCrash
+ *
+ * DESCRIPTION:     Queue g_crash, as text, for sending on a UART ahead of
+ *                  anything it forwards. tools/crashdecode.py decodes it
+ *                  (after tools/deframe, on a framed link).
+ *
+ * ARGUMENTS:       uart: The UART to send it on.
+ ***/
+static void ReportCrash(const uart_t* uart)
+{
+  static const char* const names[CRASH_REGS] = {
+    "r0", "r1", "r2", "r3", "r12", "lr", "pc", "xpsr",
+    "r4", "r5", "r6", "r7", "r8", "r9", "r10", "r11",
+    "sp", "exc_return", "cfsr", "hfsr", "mmfar", "bfar",
+  };
+  report_t report = { .uart = uart };
+
+  ReportString(&report, "\r\ncrash: exception ");
+  ReportHex(&report, g_crash.exception, 2);
+  ReportString(&report, " count ");
+  ReportHex(&report, g_crash.count, 8);
+  ReportString(&report, " cycles ");
+  ReportHex(&report, g_crash.cycles, 8);
+  for (uint32_t i = 0; i < CRASH_REGS; ++i) {
+    ReportString(&report, 0 == i % 4 ? "\r\n" : " ");
+    ReportString(&report, names[i]);
+    ReportString(&report, " ");
+    ReportHex(&report, g_crash.regs[i], 8);
+  }
+
+  for (uint32_t i = 0; i < 2; ++i) {
+    ReportString(&report, i ? "\r\nuart1" : "\r\nuart0");
+    for (uint32_t j = 0; j < g_crash.recentCount[i]; ++j) {
+      ReportString(&report, " ");
+      ReportHex(&report, g_crash.recent[i][j], 2);
+    }
+  }
+  ReportString(&report, "\r\n");
+  ReportFlush(&report);
+  IntPendSet(uart->intNum);
 }
+#endif
 
 /******************************************************************************
  * MAIN
@@ -180,22 +3273,119 @@ static void ConfigureUART(const uart_t* uart)
 
 int main()
 {
+  // The ports' peripherals power up while the clock settles. ResetISR has
+  // already started the cycle counter, which several of the modes also use
+  // for timekeeping.
+  PowerUARTPeripherals(&uart0, false);
+  PowerUARTPeripherals(&uart1, false);
+#ifdef CONFIG_UART_TAP
+  PowerUARTPeripherals(&uartTap, false);
+#endif
+
   // TODO: Use lower clock rate if using lower baud rate
-  // Set the clocking to run directly from the crystal.
+  // Set the clocking to run directly from the crystal. This waits on the
+  // oscillator and PLL status, rather than for fixed delays.
   ROM_SysCtlClockSet(SYSCTL_SYSDIV_1 | SYSCTL_USE_PLL | SYSCTL_OSC_MAIN
     | SYSCTL_XTAL_16MHZ);
+  g_boot.cycles[BOOT_CLOCK_SET] = CyclesNow();
+#if defined(CONFIG_UART_GAP) || defined(CONFIG_UART_TAP)
+  TimebaseInit();
+#endif
+#ifdef CONFIG_UART_TRACE
+  // The SWO bit rate is divided down from the clock set above.
+  TraceInit(ROM_SysCtlClockGet());
+#endif
+#ifdef CONFIG_UART_MARKERS
+  MarkersInit();
+#endif
 
   // Global enable interrupts: Must be done before configuring UART interrupts
   IntMasterEnable();
 
+  // Split the priority bits into group and subpriority (see INT_PRIORITY).
+  ROM_IntPriorityGroupingSet(INT_PRIORITY_GROUP_BITS);
+
+  // The bottom half must be in place before any top half can pend it.
+  IntRegister(FAULT_PENDSV, PendSVHandler);
+  IntPrioritySet(FAULT_PENDSV, PENDSV_INT_PRIORITY);
+
+#ifdef CONFIG_UART_TAP
+  // The tap must be ready before the first char is received.
+  ConfigureTap(&uartTap);
+#endif
   ConfigureUART(&uart0);
   ConfigureUART(&uart1);
+#ifdef CONFIG_UART_BENCH
+  RunBench();
+#endif
+
+#if defined(CONFIG_UART_ARQ) && !defined(CONFIG_UART_POLL)
+  // Retransmission timeouts. The polling loop checks them itself.
+  SysTickPeriodSet(ROM_SysCtlClockGet() / ARQ_TICK_HZ);
+  IntPrioritySet(FAULT_SYSTICK, PENDSV_INT_PRIORITY);
+  SysTickIntRegister(ArqTimerHandler);
+  SysTickIntEnable();
+  SysTickEnable();
+#endif
 
+  g_boot.cycles[BOOT_FORWARDING] = CyclesNow();
+  g_boot.us = g_boot.cycles[BOOT_CLOCK_SET]
+    / (BOOT_RESET_CLOCK_HZ / 1000000) + (g_boot.cycles[BOOT_FORWARDING]
+      - g_boot.cycles[BOOT_CLOCK_SET]) / (ROM_SysCtlClockGet() / 1000000);
+
+#ifdef CRASH_REPORT
+  // The host gets the last crash first, if SW1 was held down at reset. The
+  // bottom half, which also fills the tx queue, is held off meanwhile.
+  if (CrashValid() && CrashReportRequested()) {
+    ROM_IntPriorityMaskSet(PENDSV_INT_PRIORITY);
+    ReportCrash(&uart0);
+    ROM_IntPriorityMaskSet(0);
+  }
+#endif
+
+#ifdef CONFIG_UART_POLL
+  // Spin on the UART flag registers. Never sleeps.
+  uint32_t last = CyclesNow();
+  while (1) {
+    PollPorts();
+
+    uint32_t now = CyclesNow();
+    if (now - last > g_pollLoopMaxCycles) {
+      g_pollLoopMaxCycles = now - last;
+    }
+    last = now;
+  }
+#elif defined(CONFIG_UART_HYBRID)
+  const uint32_t idleCycles = CONFIG_UART_HYBRID_IDLE_CHARS
+    * (ROM_SysCtlClockGet() / (CONFIG_UART_BAUDRATE / 10));
+  while (1) {
+    // Interrupts are masked around the check so that a top half switching
+    // modes can't slip in between it and the wfi. A pending interrupt still
+    // wakes the core.
+    IntMasterDisable();
+    if (!g_polling) {
+      // TODO: Use SysCtlDeepSleep instead
+      asm volatile ("wfi");
+    }
+    IntMasterEnable();
+
+    if (g_polling) {
+      PollUntilIdle(idleCycles);
+    }
+  }
+#elif defined(CONFIG_UART_BERT)
+  // A debugger writing to g_bert doesn't wake the core, so the tester's
+  // commands are polled for instead of sleeping.
+  while (1) {
+    BertService();
+  }
+#else
   // Sleep until an interrupt occurs
   while (1) {
     // TODO: Use SysCtlDeepSleep instead
     asm volatile ("wfi");
   }
+#endif
 }
 
 /*****************************************************************************/
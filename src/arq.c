@@ -0,0 +1,414 @@
+/******************************************************************************
+ * NAME:	    arq.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Selective-repeat ARQ. The caller moves packets between
+ *                  this module and the framed link: ArqSend and ArqPoll
+ *                  produce packets to frame and send, and ArqReceive takes
+ *                  the payload of every good frame. In-order data comes out
+ *                  of ArqPeek/ArqRelease. See arq.h for the format.
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "arq.h"
+
+_Static_assert((ARQ_WINDOW & (ARQ_WINDOW - 1)) == 0 && ARQ_WINDOW <= 32,
+  "CONFIG_UART_ARQ_WINDOW must be a power of two, at most 32");
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        Slot
+ *
+ * DESCRIPTION:     The slot of `window' that holds sequence number `seq'.
+ ***/
+static inline arq_slot_t* Slot(arq_slot_t* window, uint8_t seq)
+{
+  return &window[seq & (ARQ_WINDOW - 1)];
+}
+
+/******************************************************************************
+ * FUNCTION:        InFlight
+ *
+ * DESCRIPTION:     Whether `seq' has been sent and not yet slid out of the
+ *                  window.
+ ***/
+static inline bool InFlight(const arq_t* arq, uint8_t seq)
+{
+  return (uint8_t)(seq - arq->txBase) < (uint8_t)(arq->txNext - arq->txBase);
+}
+
+/******************************************************************************
+ * FUNCTION:        OldestOrder
+ *
+ * DESCRIPTION:     Send order of the packet in flight that was sent longest
+ *                  ago. Orders are compared relative to it, which keeps the
+ *                  comparison valid when the counter wraps around.
+ ***/
+static uint32_t OldestOrder(arq_t* arq)
+{
+  uint32_t oldest = arq->txOrder;
+  for (uint8_t seq = arq->txBase; seq != arq->txNext; ++seq) {
+    uint32_t order = Slot(arq->tx, seq)->order;
+    if (arq->txOrder - order > arq->txOrder - oldest) {
+      oldest = order;
+    }
+  }
+
+  return oldest;
+}
+
+/******************************************************************************
+ * FUNCTION:        BuildData
+ *
+ * DESCRIPTION:     Write the DATA packet for `seq' to `packet'.
+ *
+ * RETURNS:         Size of the packet.
+ ***/
+static uint32_t BuildData(arq_t* arq, uint8_t seq, uint8_t* packet)
+{
+  arq_slot_t* slot = Slot(arq->tx, seq);
+  slot->order = arq->txOrder++;
+  packet[0] = ARQ_DATA;
+  packet[1] = seq;
+  memcpy(packet + ARQ_HEADER_SIZE, slot->data, slot->length);
+  return ARQ_HEADER_SIZE + slot->length;
+}
+
+/******************************************************************************
+ * FUNCTION:        ReceiveData
+ *
+ * DESCRIPTION:     Hold a DATA packet for delivery, and NAK any packets before
+ *                  it that haven't arrived.
+ ***/
+static void ReceiveData(arq_t* arq, const uint8_t* packet, uint32_t length)
+{
+  const uint8_t seq = packet[1];
+  const uint8_t offset = (uint8_t)(seq - arq->rxNext);
+
+  if (ARQ_WINDOW <= offset) {
+    // Either delivered already, in which case our ACK was lost, or beyond
+    // our window, which can't happen if the sender's matches ours.
+    if ((uint8_t)(arq->rxNext - seq) <= ARQ_WINDOW) {
+      arq->duplicates++;
+      arq->ackPending = true;
+    } else {
+      arq->outOfWindow++;
+    }
+    return;
+  }
+
+  arq_slot_t* slot = Slot(arq->rx, seq);
+  if (slot->done) {
+    arq->duplicates++;
+  } else {
+    slot->done = true;
+    slot->nak = false;
+    slot->length = (uint16_t)(length - ARQ_HEADER_SIZE);
+    memcpy(slot->data, packet + ARQ_HEADER_SIZE, slot->length);
+  }
+
+  for (uint8_t i = 0; i < offset; ++i) {
+    arq_slot_t* missing = Slot(arq->rx, arq->rxNext + i);
+    if (!missing->done && !missing->naked) {
+      missing->nak = true;
+      arq->nakPending = true;
+      arq->nakAfter = seq;
+    }
+  }
+
+  arq->ackPending = true;
+}
+
+/******************************************************************************
+ * FUNCTION:        ReceiveAck
+ *
+ * DESCRIPTION:     Mark the packets covered by an ACK, and slide the window
+ *                  past the ones at its start. Any packet still in flight
+ *                  that was sent before one that's now acknowledged has been
+ *                  lost, and is marked to be sent again. ACKs from before the
+ *                  start of the window are stale, and ignored.
+ ***/
+static void ReceiveAck(arq_t* arq, const uint8_t* packet)
+{
+  const uint8_t next = packet[1];
+  const uint8_t inFlight = (uint8_t)(arq->txNext - arq->txBase);
+  if ((uint8_t)(next - arq->txBase) > inFlight) {
+    return;
+  }
+
+  const uint32_t oldest = OldestOrder(arq);
+  uint32_t latest = 0;
+  bool acked = false;
+  for (uint8_t seq = arq->txBase; seq != next; ++seq) {
+    arq_slot_t* slot = Slot(arq->tx, seq);
+    if (!slot->done) {
+      slot->done = acked = true;
+      latest = slot->order - oldest > latest ? slot->order - oldest : latest;
+    }
+  }
+
+  uint32_t bitmap = (uint32_t)packet[2] | ((uint32_t)packet[3] << 8)
+    | ((uint32_t)packet[4] << 16) | ((uint32_t)packet[5] << 24);
+  for (uint8_t i = 0; 0 != bitmap; ++i, bitmap >>= 1) {
+    uint8_t seq = (uint8_t)(next + 1 + i);
+    arq_slot_t* slot = Slot(arq->tx, seq);
+    if ((bitmap & 1) && InFlight(arq, seq) && !slot->done) {
+      slot->done = acked = true;
+      latest = slot->order - oldest > latest ? slot->order - oldest : latest;
+    }
+  }
+
+  for (uint8_t seq = arq->txBase; acked && seq != arq->txNext; ++seq) {
+    arq_slot_t* slot = Slot(arq->tx, seq);
+    if (!slot->done && slot->order - oldest < latest) {
+      slot->nak = true;
+    }
+  }
+
+  while (arq->txBase != arq->txNext && Slot(arq->tx, arq->txBase)->done) {
+    arq->txBase++;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:        ReceiveNak
+ *
+ * DESCRIPTION:     Mark the packets listed in a NAK to be sent again, unless
+ *                  they have been sent again since the packet that revealed
+ *                  them missing. That also covers a NAK whose information
+ *                  already arrived in an ACK.
+ ***/
+static void ReceiveNak(arq_t* arq, const uint8_t* packet, uint32_t length)
+{
+  const uint8_t after = packet[1];
+  arq->naksReceived++;
+  if (!InFlight(arq, after)) {
+    return;
+  }
+
+  const uint32_t oldest = OldestOrder(arq);
+  const uint32_t revealed = Slot(arq->tx, after)->order - oldest;
+  for (uint32_t i = 2; i < length; ++i) {
+    arq_slot_t* slot = Slot(arq->tx, packet[i]);
+    if (InFlight(arq, packet[i]) && !slot->done
+      && slot->order - oldest < revealed) {
+      slot->nak = true;
+    }
+  }
+}
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        ArqInit
+ *
+ * DESCRIPTION:     Reset both directions. Both ends must start at the same
+ *                  time, since sequence numbers start from zero.
+ *
+ * ARGUMENTS:       arq: The link.
+ *                  timeout: Retransmission timeout. Should cover the time to
+ *                           send a full window each way, plus the latency of
+ *                           the other end.
+ ***/
+void ArqInit(arq_t* arq, uint32_t timeout)
+{
+  memset(arq, 0, sizeof(*arq));
+  arq->timeout = timeout;
+}
+
+/******************************************************************************
+ * FUNCTION:        ArqCanSend
+ *
+ * DESCRIPTION:     Whether the window has room for another packet.
+ ***/
+bool ArqCanSend(const arq_t* arq)
+{
+  return (uint8_t)(arq->txNext - arq->txBase) < ARQ_WINDOW;
+}
+
+/******************************************************************************
+ * FUNCTION:        ArqBusy
+ *
+ * DESCRIPTION:     Whether any packets are waiting to be acknowledged, so
+ *                  that ArqPoll may have retransmissions to send later.
+ ***/
+bool ArqBusy(const arq_t* arq)
+{
+  return arq->txNext != arq->txBase;
+}
+
+/******************************************************************************
+ * FUNCTION:        ArqSend
+ *
+ * DESCRIPTION:     Take a new packet into the window. Must only be called if
+ *                  ArqCanSend().
+ *
+ * ARGUMENTS:       arq: The link.
+ *                  data: The payload.
+ *                  length: Size of the payload, 1..ARQ_MAX_PAYLOAD.
+ *                  now: The current time.
+ *                  packet: Receives the packet to send, at most
+ *                          FRAME_MAX_PAYLOAD bytes.
+ *
+ * RETURNS:         Size of the packet.
+ ***/
+uint32_t ArqSend(arq_t* arq, const uint8_t* data, uint32_t length,
+  uint32_t now, uint8_t* packet)
+{
+  arq_slot_t* slot = Slot(arq->tx, arq->txNext);
+  slot->sentAt = now;
+  slot->length = (uint16_t)length;
+  slot->done = false;
+  slot->nak = false;
+  memcpy(slot->data, data, length);
+
+  arq->dataSent++;
+  arq->payloadSent += length;
+  return BuildData(arq, arq->txNext++, packet);
+}
+
+/******************************************************************************
+ * FUNCTION:        ArqPoll
+ *
+ * DESCRIPTION:     Get the next control packet or retransmission to send:
+ *                  a pending ACK first, then NAKs, then DATA packets that
+ *                  were NAKed or have timed out, oldest first. Call until it
+ *                  returns 0 (or the link is full) before sending new data.
+ *
+ * ARGUMENTS:       arq: The link.
+ *                  now: The current time.
+ *                  packet: Receives the packet to send, at most
+ *                          FRAME_MAX_PAYLOAD bytes.
+ *
+ * RETURNS:         Size of the packet, or 0 if there is nothing to send.
+ ***/
+uint32_t ArqPoll(arq_t* arq, uint32_t now, uint8_t* packet)
+{
+  if (arq->ackPending) {
+    uint32_t bitmap = 0;
+    for (uint8_t i = 0; i < ARQ_WINDOW - 1; ++i) {
+      if (Slot(arq->rx, arq->rxNext + 1 + i)->done) {
+        bitmap |= 1u << i;
+      }
+    }
+
+    packet[0] = ARQ_ACK;
+    packet[1] = arq->rxNext;
+    for (uint32_t i = 0; i < 4; ++i) {
+      packet[2 + i] = (uint8_t)(bitmap >> (8 * i));
+    }
+    arq->ackPending = false;
+    arq->acksSent++;
+    return ARQ_ACK_SIZE;
+  }
+
+  if (arq->nakPending) {
+    uint32_t length = 0;
+    packet[length++] = ARQ_NAK;
+    packet[length++] = arq->nakAfter;
+    for (uint8_t i = 0; i < ARQ_WINDOW; ++i) {
+      arq_slot_t* slot = Slot(arq->rx, arq->rxNext + i);
+      if (slot->nak) {
+        slot->nak = false;
+        slot->naked = true;
+        packet[length++] = (uint8_t)(arq->rxNext + i);
+      }
+    }
+    arq->nakPending = false;
+    arq->naksSent++;
+    return length;
+  }
+
+  for (uint8_t seq = arq->txBase; seq != arq->txNext; ++seq) {
+    arq_slot_t* slot = Slot(arq->tx, seq);
+    if (slot->done || !(slot->nak || now - slot->sentAt >= arq->timeout)) {
+      continue;
+    }
+
+    if (!slot->nak) {
+      arq->timeouts++;
+    }
+    slot->nak = false;
+    slot->sentAt = now;
+    arq->retransmits++;
+    return BuildData(arq, seq, packet);
+  }
+
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:        ArqReceive
+ *
+ * DESCRIPTION:     Handle a packet from the other end. Malformed packets are
+ *                  ignored; the frame CRC makes them unlikely.
+ *
+ * ARGUMENTS:       arq: The link.
+ *                  packet: The payload of a good frame.
+ *                  length: Size of the payload.
+ ***/
+void ArqReceive(arq_t* arq, const uint8_t* packet, uint32_t length)
+{
+  if (ARQ_DATA == packet[0] && ARQ_HEADER_SIZE < length
+    && length <= ARQ_HEADER_SIZE + ARQ_MAX_PAYLOAD) {
+    ReceiveData(arq, packet, length);
+  } else if (ARQ_ACK == packet[0] && ARQ_ACK_SIZE == length) {
+    ReceiveAck(arq, packet);
+  } else if (ARQ_NAK == packet[0] && 2 < length) {
+    ReceiveNak(arq, packet, length);
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:        ArqPeek
+ *
+ * DESCRIPTION:     Get the next packet of in-order data, if it has arrived.
+ *                  It stays in the window until ArqRelease.
+ *
+ * RETURNS:         Size of the payload, or 0 if it hasn't arrived.
+ ***/
+uint32_t ArqPeek(const arq_t* arq, const uint8_t** data)
+{
+  const arq_slot_t* slot = &arq->rx[arq->rxNext & (ARQ_WINDOW - 1)];
+  if (!slot->done) {
+    return 0;
+  }
+
+  *data = slot->data;
+  return slot->length;
+}
+
+/******************************************************************************
+ * FUNCTION:        ArqRelease
+ *
+ * DESCRIPTION:     Release the packet returned by ArqPeek, opening the window
+ *                  for another. The other end learns of it in the next ACK.
+ ***/
+void ArqRelease(arq_t* arq)
+{
+  arq_slot_t* slot = Slot(arq->rx, arq->rxNext);
+  arq->payloadDelivered += slot->length;
+  slot->done = false;
+  slot->nak = false;
+  slot->naked = false;
+  arq->rxNext++;
+  arq->ackPending = true;
+}
+
+/*****************************************************************************/
@@ -0,0 +1,127 @@
+/******************************************************************************
+ * NAME:	    arq.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Selective-repeat ARQ over the framed link to the host.
+ *                  Each frame's payload is one packet:
+ *
+ *                    DATA seq payload...       up to ARQ_MAX_PAYLOAD bytes
+ *                    ACK  next bitmap[4]       every seq before `next' was
+ *                                              delivered, and bit i of the
+ *                                              (little-endian) bitmap is set
+ *                                              if next + 1 + i is held
+ *                    NAK  after seq...         these seqs were missing when
+ *                                              `after' arrived
+ *
+ *                  Sequence numbers are 8 bits. Each end keeps up to
+ *                  ARQ_WINDOW packets in flight, and holds up to ARQ_WINDOW
+ *                  packets received out of order, so only the packets that
+ *                  were actually lost are sent again. Since the line never
+ *                  reorders, a packet is known to be lost (and sent again)
+ *                  as soon as one sent after it is acknowledged, so the
+ *                  timeout only comes into play when the line goes quiet.
+ *                  Both ends must use the same window.
+ *
+ *                  The module has no hardware dependencies, and the caller
+ *                  supplies the time, so the host end (tools/arqhost.c) runs
+ *                  the same code.
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+#ifndef ARQ_H
+#define ARQ_H
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "frame.h"
+
+// Packets in flight in each direction. Each costs two slots of about
+// ARQ_MAX_PAYLOAD bytes of SRAM (one to send, one to receive). Must be a
+// power of two, and at most 32 so that an ACK can cover the whole window.
+#ifndef CONFIG_UART_ARQ_WINDOW
+#define CONFIG_UART_ARQ_WINDOW 16
+#endif
+#define ARQ_WINDOW CONFIG_UART_ARQ_WINDOW
+
+// Format constants, shared with the host end.
+#define ARQ_DATA            0x01
+#define ARQ_ACK             0x02
+#define ARQ_NAK             0x03
+#define ARQ_HEADER_SIZE     2
+#define ARQ_ACK_SIZE        6
+#define ARQ_MAX_PAYLOAD     (FRAME_MAX_PAYLOAD - ARQ_HEADER_SIZE)
+
+// One packet of the window.
+typedef struct {
+
+  uint32_t sentAt;
+  // Sender: order in which it was last sent.
+  uint32_t order;
+  uint16_t length;
+  // Sender: acknowledged. Receiver: held.
+  bool done;
+  // Sender: NAKed, and not yet sent again. Receiver: to be NAKed.
+  bool nak;
+  // Receiver: NAK sent.
+  bool naked;
+  uint8_t data[ARQ_MAX_PAYLOAD];
+
+} arq_slot_t;
+
+typedef struct {
+
+  // Sender. Seqs from txBase up to txNext are in flight.
+  arq_slot_t tx[ARQ_WINDOW];
+  uint8_t txBase;
+  uint8_t txNext;
+  uint32_t txOrder;
+  // Time after which an unacknowledged packet is sent again. In the same
+  // units as the `now' passed to ArqSend and ArqPoll.
+  uint32_t timeout;
+
+  // Receiver. rxNext is the next seq to deliver.
+  arq_slot_t rx[ARQ_WINDOW];
+  uint8_t rxNext;
+  uint8_t nakAfter;
+  bool ackPending;
+  bool nakPending;
+
+  // Statistics. Goodput is payloadDelivered over the line time.
+  uint32_t dataSent;
+  uint32_t retransmits;
+  uint32_t timeouts;
+  uint32_t acksSent;
+  uint32_t naksSent;
+  uint32_t naksReceived;
+  uint32_t duplicates;
+  uint32_t outOfWindow;
+  uint32_t payloadSent;
+  uint32_t payloadDelivered;
+
+} arq_t;
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+void ArqInit(arq_t* arq, uint32_t timeout);
+bool ArqCanSend(const arq_t* arq);
+bool ArqBusy(const arq_t* arq);
+uint32_t ArqSend(arq_t* arq, const uint8_t* data, uint32_t length,
+  uint32_t now, uint8_t* packet);
+uint32_t ArqPoll(arq_t* arq, uint32_t now, uint8_t* packet);
+void ArqReceive(arq_t* arq, const uint8_t* packet, uint32_t length);
+uint32_t ArqPeek(const arq_t* arq, const uint8_t** data);
+void ArqRelease(arq_t* arq);
+
+#endif // ARQ_H
+
+/*****************************************************************************/
@@ -0,0 +1,50 @@
+/******************************************************************************
+ * NAME:	    boot.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Timestamps of the boot stages, from reset until the
+ *                  bridge starts forwarding, read with a debugger from
+ *                  g_boot. ResetISR (startup_gcc.c) starts the cycle counter
+ *                  and stamps its own stages, and main() the rest.
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+#ifndef BOOT_H
+#define BOOT_H
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stdint.h>
+
+// Boot stages, in order.
+#define BOOT_STACK_PAINTED      0
+#define BOOT_DATA_COPIED        1
+#define BOOT_BSS_ZEROED         2
+#define BOOT_CLOCK_SET          3
+#define BOOT_FORWARDING         4
+#define BOOT_STAGES             5
+
+// The core runs from the precision internal oscillator until the clock is
+// set, so the stamps up to BOOT_CLOCK_SET count cycles of this clock.
+#define BOOT_RESET_CLOCK_HZ     16000000
+
+typedef struct {
+
+  // The cycle counter at the end of each stage, counted from reset.
+  uint32_t cycles[BOOT_STAGES];
+  // Reset to forwarding, in microseconds.
+  uint32_t us;
+
+} boot_t;
+
+extern boot_t g_boot;
+
+#endif // BOOT_H
+
+/*****************************************************************************/
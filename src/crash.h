@@ -0,0 +1,126 @@
+/******************************************************************************
+ * NAME:	    crash.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The crash record. A hard fault or an NMI (FaultISR and
+ *                  NmiSR, in startup_gcc.c) hands the registers to
+ *                  CrashCapture(), which writes them, the fault status
+ *                  registers and the last chars sent on each UART into
+ *                  g_crash, then resets the chip straight away. g_crash is
+ *                  in no-init SRAM (see SerialBridge.ld), so it survives the
+ *                  reset, and any reset short of a power cycle. It can be
+ *                  read with a debugger, or sent to the host on request: hold
+ *                  SW1 while the board resets.
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+#ifndef CRASH_H
+#define CRASH_H
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Marks a record that was written by CrashCapture(), rather than left in
+// SRAM by the last power cycle.
+#define CRASH_MAGIC 0xDEC0DE05
+
+// Chars kept from the tx queue of each UART. Must be a multiple of 4.
+#define CRASH_RECENT_CHARS 32
+
+// The registers in a record: r0-xpsr as the exception stacked them, then the
+// ones it didn't, the stack pointer of the code that crashed, the exception
+// return value, and the fault status and address registers.
+#define CRASH_R0            0
+#define CRASH_R1            1
+#define CRASH_R2            2
+#define CRASH_R3            3
+#define CRASH_R12           4
+#define CRASH_LR            5
+#define CRASH_PC            6
+#define CRASH_XPSR          7
+#define CRASH_R4            8
+#define CRASH_SP            16
+#define CRASH_EXC_RETURN    17
+#define CRASH_CFSR          18
+#define CRASH_HFSR          19
+#define CRASH_MMFAR         20
+#define CRASH_BFAR          21
+#define CRASH_REGS          22
+
+typedef struct {
+
+  uint32_t magic;
+  // Of everything after it.
+  uint32_t checksum;
+  // Crashes since the last power cycle.
+  uint32_t count;
+  // The exception that caught it: 2 for an NMI, 3 for a hard fault.
+  uint32_t exception;
+  // Cycles from reset to the crash.
+  uint32_t cycles;
+  uint32_t regs[CRASH_REGS];
+  // The last chars taken from each UART's tx queue, oldest first.
+  uint32_t recentCount[2];
+  uint8_t recent[2][CRASH_RECENT_CHARS];
+
+} crash_t;
+
+extern crash_t g_crash;
+
+/******************************************************************************
+ * FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        CrashChecksum
+ *
+ * DESCRIPTION:     Checksum of a record, over every word after `checksum'.
+ ***/
+static inline uint32_t CrashChecksum(const crash_t* crash)
+{
+  const uint32_t* word = &crash->count;
+  uint32_t words = (sizeof(crash_t) - offsetof(crash_t, count)) / 4;
+  uint32_t sum = 0;
+  while (words--) {
+    sum = ((sum << 5) | (sum >> 27)) ^ *word++;
+  }
+
+  return sum;
+}
+
+/******************************************************************************
+ * FUNCTION:        CrashValid
+ *
+ * DESCRIPTION:     Whether g_crash holds a record.
+ ***/
+static inline bool CrashValid(void)
+{
+  return CRASH_MAGIC == g_crash.magic
+    && CrashChecksum(&g_crash) == g_crash.checksum;
+}
+
+/******************************************************************************
+ * FUNCTION:        CrashCapture
+ *
+ * DESCRIPTION:     Record a crash and reset. Defined in SerialBridge.c, and
+ *                  only ever branched to by FaultISR and NmiSR.
+ *
+ * ARGUMENTS:       frame: The registers the exception stacked.
+ *                  excReturn: The exception return value (lr on entry).
+ *                  saved: r4-r11, as pushed by the handler.
+ ***/
+void CrashCapture(const uint32_t* frame, uint32_t excReturn,
+  const uint32_t* saved) __attribute__((noreturn));
+
+#endif // CRASH_H
+
+/*****************************************************************************/
@@ -0,0 +1,71 @@
+/******************************************************************************
+ * NAME:	    cycles.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Access to the Cortex-M4 DWT cycle counter, for measuring
+ *                  latency in CPU cycles. The counter is 32 bits wide, so at
+ *                  80 MHz differences are valid for up to ~53 seconds.
+ *                  Modules shared with the host tools read zero instead when
+ *                  built for the host.
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+#ifndef CYCLES_H
+#define CYCLES_H
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stdint.h>
+#include "inc/hw_nvic.h"
+#include "inc/hw_types.h"
+
+// TivaWare doesn't define the DWT registers.
+#define DWT_CTRL                0xE0001000  // DWT Control
+#define DWT_CYCCNT              0xE0001004  // DWT Cycle Count
+#define DWT_CTRL_CYCCNTENA      0x00000001  // Cycle Count Enable
+#define NVIC_DBG_INT_TRCENA     0x01000000  // Trace Enable (DEMCR.TRCENA)
+
+/******************************************************************************
+ * FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        CyclesInit
+ *
+ * DESCRIPTION:     Start the cycle counter from zero. Works with or without a
+ *                  debugger attached. ResetISR calls this first, so that the
+ *                  counter also times the boot (see boot.h).
+ ***/
+static inline void CyclesInit(void)
+{
+#if defined(__arm__)
+  HWREG(NVIC_DBG_INT) |= NVIC_DBG_INT_TRCENA;
+  HWREG(DWT_CYCCNT) = 0;
+  HWREG(DWT_CTRL) |= DWT_CTRL_CYCCNTENA;
+#endif
+}
+
+/******************************************************************************
+ * FUNCTION:        CyclesNow
+ *
+ * DESCRIPTION:     Read the cycle counter. Subtract two readings (as uint32_t)
+ *                  to get the elapsed cycles between them.
+ ***/
+static inline uint32_t CyclesNow(void)
+{
+#if defined(__arm__)
+  return HWREG(DWT_CYCCNT);
+#else
+  return 0;
+#endif
+}
+
+#endif // CYCLES_H
+
+/*****************************************************************************/
@@ -0,0 +1,178 @@
+/******************************************************************************
+ * NAME:	    frame.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Framing and CRC checking for the link to the host. The
+ *                  CRC is the word-at-a-time Crc32Slice4 from the driver
+ *                  library. See frame.h for the format.
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "driverlib/sw_crc.h"
+#include "cycles.h"
+#include "frame.h"
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        FrameCrc
+ *
+ * DESCRIPTION:     CRC-32 of `length' bytes, accounted in the link's
+ *                  statistics.
+ ***/
+static uint32_t FrameCrc(framelink_t* link, const uint8_t* data,
+  uint32_t length)
+{
+  uint32_t start = CyclesNow();
+  uint32_t crc = Crc32Slice4(0xffffffff, data, length) ^ 0xffffffff;
+  link->crcCycles += CyclesNow() - start;
+  link->crcBytes += length;
+  return crc;
+}
+
+/******************************************************************************
+ * FUNCTION:        Stuff
+ *
+ * DESCRIPTION:     Write one byte of a frame body, escaping it if necessary.
+ *
+ * RETURNS:         Number of bytes written.
+ ***/
+static inline uint32_t Stuff(uint8_t c, uint8_t* out)
+{
+  if (FRAME_FLAG == c || FRAME_ESCAPE == c) {
+    out[0] = FRAME_ESCAPE;
+    out[1] = c ^ FRAME_XOR;
+    return 2;
+  }
+
+  out[0] = c;
+  return 1;
+}
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        FrameInit
+ *
+ * DESCRIPTION:     Reset the link. The receiver discards everything up to the
+ *                  first flag.
+ ***/
+void FrameInit(framelink_t* link)
+{
+  memset(link, 0, sizeof(*link));
+  link->overlong = true;
+}
+
+/******************************************************************************
+ * FUNCTION:        FrameEncode
+ *
+ * DESCRIPTION:     Build one frame around `payload'.
+ *
+ * ARGUMENTS:       link: The link the frame is sent on.
+ *                  payload: The payload.
+ *                  length: Size of the payload, at most FRAME_MAX_PAYLOAD.
+ *                  out: Output buffer of at least FRAME_BOUND(length) bytes.
+ *
+ * RETURNS:         Number of bytes written to `out'.
+ ***/
+uint32_t FrameEncode(framelink_t* link, const uint8_t* payload,
+  uint32_t length, uint8_t* out)
+{
+  uint32_t crc = FrameCrc(link, payload, length);
+  uint32_t written = 0;
+
+  out[written++] = FRAME_FLAG;
+  for (uint32_t i = 0; i < length; ++i) {
+    written += Stuff(payload[i], out + written);
+  }
+  for (uint32_t i = 0; i < FRAME_CRC_SIZE; ++i) {
+    written += Stuff((uint8_t)(crc >> (8 * i)), out + written);
+  }
+  out[written++] = FRAME_FLAG;
+
+  link->framesSent++;
+  return written;
+}
+
+/******************************************************************************
+ * FUNCTION:        FrameReceive
+ *
+ * DESCRIPTION:     Feed one received byte to the link's receiver. When it
+ *                  completes a frame with a good CRC, the payload is at the
+ *                  start of link->buffer until the next call.
+ *
+ * RETURNS:         Size of the payload of a good frame, or 0.
+ ***/
+uint32_t FrameReceive(framelink_t* link, uint8_t c)
+{
+  if (FRAME_FLAG == c) {
+    uint32_t length = link->length;
+    bool overlong = link->overlong;
+    link->length = 0;
+    link->escaped = false;
+    link->overlong = false;
+
+    // Back-to-back flags are idle fill, not frames.
+    if (overlong || 0 == length) {
+      return 0;
+    }
+
+    if (length <= FRAME_CRC_SIZE) {
+      link->crcErrors++;
+      return 0;
+    }
+
+    length -= FRAME_CRC_SIZE;
+    const uint8_t* trailer = link->buffer + length;
+    uint32_t crc = (uint32_t)trailer[0] | ((uint32_t)trailer[1] << 8)
+      | ((uint32_t)trailer[2] << 16) | ((uint32_t)trailer[3] << 24);
+    if (crc != FrameCrc(link, link->buffer, length)) {
+      link->crcErrors++;
+      return 0;
+    }
+
+    link->framesReceived++;
+    return length;
+  }
+
+  if (link->overlong) {
+    return 0;
+  }
+
+  if (FRAME_ESCAPE == c) {
+    link->escaped = true;
+    return 0;
+  }
+
+  if (link->escaped) {
+    c ^= FRAME_XOR;
+    link->escaped = false;
+  }
+
+  if (link->length == sizeof(link->buffer)) {
+    // Too long to be one of ours: drop it and wait for the next flag.
+    link->overlong = true;
+    link->overlongFrames++;
+    return 0;
+  }
+
+  link->buffer[link->length++] = c;
+  return 0;
+}
+
+/*****************************************************************************/
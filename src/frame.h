@@ -0,0 +1,70 @@
+/******************************************************************************
+ * NAME:	    frame.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    HDLC-style framing for the link to the host. A frame is
+ *
+ *                    FLAG payload CRC FLAG
+ *
+ *                  where CRC is the CRC-32 of the payload (little-endian),
+ *                  and any FLAG or ESCAPE byte in the payload or CRC is sent
+ *                  as ESCAPE followed by the byte XOR 0x20. A frame whose CRC
+ *                  doesn't match is dropped, so corruption on the line is
+ *                  never passed through. See tools/deframe.c for the host end.
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+#ifndef FRAME_H
+#define FRAME_H
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Format constants, shared with the host tool.
+#define FRAME_FLAG          0x7e
+#define FRAME_ESCAPE        0x7d
+#define FRAME_XOR           0x20
+#define FRAME_CRC_SIZE      4
+#define FRAME_MAX_PAYLOAD   256
+
+// Most bytes FrameEncode can produce for `n' bytes of payload.
+#define FRAME_BOUND(n) (2 * ((n) + FRAME_CRC_SIZE) + 2)
+
+// State of one framed link: the receiver, and statistics for both
+// directions. crcCycles / crcBytes is the CPU cost of the CRC per byte.
+typedef struct {
+
+  uint8_t buffer[FRAME_MAX_PAYLOAD + FRAME_CRC_SIZE];
+  uint32_t length;
+  bool escaped;
+  bool overlong;
+
+  uint32_t framesSent;
+  uint32_t framesReceived;
+  uint32_t crcErrors;
+  uint32_t overlongFrames;
+  uint32_t crcBytes;
+  uint32_t crcCycles;
+
+} framelink_t;
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+void FrameInit(framelink_t* link);
+uint32_t FrameEncode(framelink_t* link, const uint8_t* payload,
+  uint32_t length, uint8_t* out);
+uint32_t FrameReceive(framelink_t* link, uint8_t c);
+
+#endif // FRAME_H
+
+/*****************************************************************************/
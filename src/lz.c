@@ -0,0 +1,197 @@
+/******************************************************************************
+ * NAME:	    lz.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Streaming LZ77 compressor. The match finder keeps one
+ *                  candidate per 3-byte hash (the most recent), which costs
+ *                  one table lookup and a short compare per input byte, and
+ *                  about 2 KB of SRAM per stream. See lz.h for the format.
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stdbool.h>
+#include <string.h>
+#include "lz.h"
+
+_Static_assert((LZ_WINDOW & (LZ_WINDOW - 1)) == 0,
+  "LZ_WINDOW must be a power of two");
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        Hash
+ *
+ * DESCRIPTION:     Hash the three bytes at `data' into the match table.
+ ***/
+static inline uint32_t Hash(const uint8_t* data)
+{
+  uint32_t key = ((uint32_t)data[0] << 16) | ((uint32_t)data[1] << 8)
+    | data[2];
+  return (key * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+/******************************************************************************
+ * FUNCTION:        ByteAt
+ *
+ * DESCRIPTION:     Get the byte at stream position `at'. Positions before the
+ *                  current one come from the window, the rest from the input
+ *                  (starting at `in', which is the current position).
+ ***/
+static inline uint8_t ByteAt(const lz_t* lz, uint32_t at, const uint8_t* in)
+{
+  if ((int32_t)(at - lz->position) < 0) {
+    return lz->window[at & (LZ_WINDOW - 1)];
+  }
+
+  return in[at - lz->position];
+}
+
+/******************************************************************************
+ * FUNCTION:        EmitLiterals
+ *
+ * DESCRIPTION:     Write the pending literal run, if any, to `out'. The bytes
+ *                  are still in the window.
+ *
+ * RETURNS:         Number of bytes written.
+ ***/
+static uint32_t EmitLiterals(lz_t* lz, uint8_t* out)
+{
+  uint32_t count = lz->literals;
+  if (0 == count) {
+    return 0;
+  }
+
+  *out++ = (uint8_t)(count - 1);
+  uint32_t start = lz->position - count;
+  for (uint32_t i = 0; i < count; ++i) {
+    out[i] = lz->window[(start + i) & (LZ_WINDOW - 1)];
+  }
+
+  lz->literals = 0;
+  return count + 1;
+}
+
+/******************************************************************************
+ * FUNCTION:        Advance
+ *
+ * DESCRIPTION:     Move one byte of input into the window.
+ ***/
+static inline void Advance(lz_t* lz, uint8_t c)
+{
+  lz->window[lz->position & (LZ_WINDOW - 1)] = c;
+  lz->position++;
+}
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        LzInit
+ *
+ * DESCRIPTION:     Start a new stream. The decoder must start from a zeroed
+ *                  window at the same time, since matches may refer to it.
+ ***/
+void LzInit(lz_t* lz)
+{
+  memset(lz, 0, sizeof(*lz));
+}
+
+/******************************************************************************
+ * FUNCTION:        LzCompress
+ *
+ * DESCRIPTION:     Compress the next `length' bytes of the stream. The end of
+ *                  the input may be held back as a pending literal run, which
+ *                  is written by a later call or by LzFlush.
+ *
+ * ARGUMENTS:       lz: The stream.
+ *                  in: Input bytes.
+ *                  length: Number of input bytes.
+ *                  out: Output buffer of at least LZ_BOUND(length) bytes.
+ *
+ * RETURNS:         Number of bytes written to `out'.
+ ***/
+uint32_t LzCompress(lz_t* lz, const uint8_t* in, uint32_t length,
+  uint8_t* out)
+{
+  uint32_t written = 0;
+  uint32_t i = 0;
+
+  while (i < length) {
+    uint32_t matched = 0;
+    uint32_t distance = 0;
+    if (i + LZ_MIN_MATCH <= length) {
+      uint32_t hash = Hash(in + i);
+      uint32_t candidate = lz->head[hash];
+      lz->head[hash] = lz->position;
+
+      // The window starts out zeroed on both ends, so any distance within
+      // it is valid, even near the start of the stream.
+      distance = lz->position - candidate;
+      if (0 < distance && distance <= LZ_WINDOW) {
+        uint32_t limit = length - i < LZ_MAX_MATCH ? length - i : LZ_MAX_MATCH;
+        while (matched < limit
+          && ByteAt(lz, candidate + matched, in + i) == in[i + matched]) {
+          matched++;
+        }
+      }
+    }
+
+    if (matched < LZ_MIN_MATCH) {
+      Advance(lz, in[i++]);
+      if (++lz->literals == LZ_MAX_LITERALS) {
+        written += EmitLiterals(lz, out + written);
+      }
+      continue;
+    }
+
+    written += EmitLiterals(lz, out + written);
+    out[written++] = (uint8_t)(LZ_MATCH_FLAG | ((matched - LZ_MIN_MATCH) << 2)
+      | ((distance - 1) >> 8));
+    out[written++] = (uint8_t)(distance - 1);
+
+    // Index the positions inside the match too, so that later repeats of
+    // them can be found.
+    Advance(lz, in[i++]);
+    for (uint32_t n = 1; n < matched; ++n, ++i) {
+      if (i + LZ_MIN_MATCH <= length) {
+        lz->head[Hash(in + i)] = lz->position;
+      }
+      Advance(lz, in[i]);
+    }
+  }
+
+  lz->inBytes += length;
+  lz->outBytes += written;
+  return written;
+}
+
+/******************************************************************************
+ * FUNCTION:        LzFlush
+ *
+ * DESCRIPTION:     Write out the pending literal run, so that the decoder has
+ *                  every byte compressed so far. The stream continues.
+ *
+ * ARGUMENTS:       lz: The stream.
+ *                  out: Output buffer of at least LZ_MAX_LITERALS bytes.
+ *
+ * RETURNS:         Number of bytes written to `out'.
+ ***/
+uint32_t LzFlush(lz_t* lz, uint8_t* out)
+{
+  uint32_t written = EmitLiterals(lz, out);
+  lz->outBytes += written;
+  return written;
+}
+
+/*****************************************************************************/
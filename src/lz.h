@@ -0,0 +1,77 @@
+/******************************************************************************
+ * NAME:	    lz.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Streaming LZ77 compressor with a small window, for the
+ *                  target-to-host direction of the bridge. The stream is a
+ *                  sequence of tokens:
+ *
+ *                    0nnnnnnn                  literal run: n + 1 bytes follow
+ *                    1lllllhh oooooooo         match: copy l + 3 bytes from
+ *                                              hhoooooooo + 1 bytes back
+ *
+ *                  Matches may refer to anything sent in the last LZ_WINDOW
+ *                  bytes, including earlier calls, so the decoder keeps the
+ *                  same window. See tools/unlz.c.
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+#ifndef LZ_H
+#define LZ_H
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stdint.h>
+
+// Format constants, shared with the decoder.
+#define LZ_WINDOW       1024
+#define LZ_MIN_MATCH    3
+#define LZ_MAX_MATCH    (LZ_MIN_MATCH + 31)
+#define LZ_MAX_LITERALS 128
+#define LZ_MATCH_FLAG   0x80
+
+// Entries in the match finder's hash table.
+#define LZ_HASH_BITS    8
+#define LZ_HASH_SIZE    (1 << LZ_HASH_BITS)
+
+// Most output LzCompress can produce for `n' input bytes, including a
+// pending literal run carried over from a previous call.
+#define LZ_BOUND(n) ((n) + (n) / LZ_MAX_LITERALS + LZ_MAX_LITERALS + 2)
+
+typedef struct {
+
+  // Input history, indexed by stream position modulo the window.
+  uint8_t window[LZ_WINDOW];
+  // Most recent stream position of each 3-byte hash.
+  uint32_t head[LZ_HASH_SIZE];
+  // Stream position of the next input byte.
+  uint32_t position;
+  // Input bytes before `position' not yet emitted as a literal run.
+  uint32_t literals;
+
+  // Statistics. The compression ratio is inBytes / outBytes, and cycles /
+  // inBytes is the cost per byte.
+  uint32_t inBytes;
+  uint32_t outBytes;
+  uint32_t cycles;
+
+} lz_t;
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+void LzInit(lz_t* lz);
+uint32_t LzCompress(lz_t* lz, const uint8_t* in, uint32_t length,
+  uint8_t* out);
+uint32_t LzFlush(lz_t* lz, uint8_t* out);
+
+#endif // LZ_H
+
+/*****************************************************************************/
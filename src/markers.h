@@ -0,0 +1,83 @@
+/******************************************************************************
+ * NAME:	    markers.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Timing markers for a logic analyser. Each marker is a
+ *                  GPIO pin on port E, held high while a piece of the
+ *                  forwarding path runs:
+ *
+ *                    PE2   UART0 interrupt
+ *                    PE3   UART1 interrupt
+ *                    PE4   bottom half (PendSV)
+ *                    PE5   RX FIFO being drained, in either top half
+ *
+ *                  The pins are written through the AHB aperture, with the
+ *                  pin in the address mask, so each edge is one store that
+ *                  touches no other pin. Without CONFIG_UART_MARKERS the
+ *                  macros compile to nothing. See tools/markers.py for the
+ *                  analysis of a capture.
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+#ifndef MARKERS_H
+#define MARKERS_H
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#ifdef CONFIG_UART_MARKERS
+
+#include <stdint.h>
+#include "inc/hw_gpio.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_sysctl.h"
+#include "inc/hw_types.h"
+#include "driverlib/gpio.h"
+#include "driverlib/rom.h"
+#include "driverlib/sysctl.h"
+
+#define MARKER_BASE         GPIO_PORTE_AHB_BASE
+#define MARKER_UART0        GPIO_PIN_2
+#define MARKER_UART1        GPIO_PIN_3
+#define MARKER_BOTTOM_HALF  GPIO_PIN_4
+#define MARKER_RX           GPIO_PIN_5
+#define MARKER_PINS         (MARKER_UART0 | MARKER_UART1 | MARKER_BOTTOM_HALF \
+  | MARKER_RX)
+
+#define MARKER_HIGH(pin) (HWREG(MARKER_BASE + GPIO_O_DATA + ((pin) << 2)) \
+  = (pin))
+#define MARKER_LOW(pin) (HWREG(MARKER_BASE + GPIO_O_DATA + ((pin) << 2)) = 0)
+
+/******************************************************************************
+ * FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        MarkersInit
+ *
+ * DESCRIPTION:     Make the marker pins outputs, driven low. Port E is moved
+ *                  to the AHB, which the RS-485 driver-enable pin also uses.
+ ***/
+static inline void MarkersInit(void)
+{
+  ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOE);
+  HWREG(SYSCTL_GPIOHBCTL) |= SYSCTL_GPIOHBCTL_PORTE;
+  ROM_GPIOPinTypeGPIOOutput(MARKER_BASE, MARKER_PINS);
+  HWREG(MARKER_BASE + GPIO_O_DATA + (MARKER_PINS << 2)) = 0;
+}
+
+#else
+
+#define MARKER_HIGH(pin) ((void)0)
+#define MARKER_LOW(pin) ((void)0)
+
+#endif // CONFIG_UART_MARKERS
+
+#endif // MARKERS_H
+
+/*****************************************************************************/
@@ -0,0 +1,311 @@
+/******************************************************************************
+ * NAME:	    ports.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Compile-time description of the bridged ports. Each port
+ *                  is one parenthesized list of its hardware:
+ *
+ *                    (name, uart, peer, gpio, rx, tx,
+ *                     breakTimer, coalesceTimer, gapTimer, rxDma, txDma)
+ *
+ *                  `name' is pasted into its handlers' names (UARTZeroHandler
+ *                  ...), `uart' and `peer' are the numbers of its UART and of
+ *                  the UART it forwards to, `gpio' is the letter of the GPIO
+ *                  port and `rx', `tx' the pins on it, the timers are
+ *                  general purpose timer numbers and the DMA fields are
+ *                  channel numbers. Everything else is derived from these by
+ *                  token pasting, so a mistyped pin, timer or channel fails
+ *                  the build instead of the bridge. The PORT_* macros take a
+ *                  port apart:
+ *
+ *                    PORT_HARDWARE       uart_t initializers for its pins,
+ *                                        UART, interrupt and timers
+ *                    PORT_CHECKS         static checks of the pin mux, DMA
+ *                                        channels and interrupt numbers
+ *                    PORT_*_HANDLER      its interrupt handlers
+ *
+ *                  and BRIDGE_PORTS(X) applies X to every port. The handlers
+ *                  are generated per port, with the port's uart_t (a static
+ *                  const) passed to the forced-inline generic handler, so
+ *                  each one is compiled for its own port, with the register
+ *                  addresses as immediates. The Port* register accessors
+ *                  are the driverlib calls of the forwarding path, inlined.
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+#ifndef PORTS_H
+#define PORTS_H
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_uart.h"
+#include "driverlib/pin_map.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/udma.h"
+
+#define PORT_UPSTREAM   (Zero, 0, 1, A, 0, 1, 0, 2, 4, 8, 9)
+#define PORT_DOWNSTREAM (One, 1, 0, B, 0, 1, 1, 3, 5, 22, 23)
+
+#define BRIDGE_PORTS(X) X(PORT_UPSTREAM) X(PORT_DOWNSTREAM)
+
+// For functions on the forwarding path, which must be compiled into each
+// handler for its own port.
+#define PORT_INLINE static inline __attribute__((always_inline))
+
+// Call macro_(...) with the fields of `port' as its arguments.
+#define PORT_APPLY(macro_, port) macro_ port
+
+// Index of each GPIO port in a pin_map.h pin mux value.
+#define PORT_GPIO_INDEX_A 0
+#define PORT_GPIO_INDEX_B 1
+#define PORT_GPIO_INDEX_C 2
+#define PORT_GPIO_INDEX_D 3
+#define PORT_GPIO_INDEX_E 4
+#define PORT_GPIO_INDEX_F 5
+
+/******************************************************************************
+ * HARDWARE
+ ***/
+
+#define PORT_TIMER(timer, handler_) {           \
+    .periph = SYSCTL_PERIPH_TIMER##timer,       \
+    .base = TIMER##timer##_BASE,                \
+    .intNum = INT_TIMER##timer##A,              \
+    .handler = handler_,                        \
+  }
+
+#ifdef CONFIG_UART_COALESCE
+#define PORT_COALESCE_TIMER(name, timer)                                \
+  .coalesceTimer = PORT_TIMER(timer, CoalesceTimer##name##Handler),
+#else
+#define PORT_COALESCE_TIMER(name, timer)
+#endif
+
+#ifdef CONFIG_UART_GAP
+#define PORT_GAP_TIMER(name, timer)                             \
+  .gapTimer = PORT_TIMER(timer, GapTimer##name##Handler),
+#else
+#define PORT_GAP_TIMER(name, timer)
+#endif
+
+#define PORT_HARDWARE_(name, u, peer, g, rx, tx, bt, ct, gt, rxDma, txDma) \
+  .hostGpio = SYSCTL_PERIPH_GPIO##g,                                    \
+  .hostUart = SYSCTL_PERIPH_UART##u,                                    \
+  .rxPin = GPIO_P##g##rx##_U##u##RX,                                    \
+  .txPin = GPIO_P##g##tx##_U##u##TX,                                    \
+  .gpioBase = GPIO_PORT##g##_BASE,                                      \
+  .gpioPins = GPIO_PIN_##rx | GPIO_PIN_##tx,                            \
+  .rxGpioPin = GPIO_PIN_##rx,                                           \
+  .uartBase = UART##u##_BASE,                                           \
+  .intHandler = UART##name##Handler,                                    \
+  .intNum = INT_UART##u,                                                \
+  .breakTimer = PORT_TIMER(bt, BreakTimer##name##Handler),              \
+  PORT_COALESCE_TIMER(name, ct)                                         \
+  PORT_GAP_TIMER(name, gt)                                              \
+  .port = &port##u,
+
+#define PORT_HARDWARE(port) PORT_APPLY(PORT_HARDWARE_, port)
+
+/******************************************************************************
+ * CHECKS
+ ***/
+
+// The pins must be muxed to the port's UART on its GPIO port, the DMA
+// channels must be ones the port's UART can be mapped to (these are checked
+// ahead of the DMA transfers in the TODO list), and the interrupts must be
+// ones the NVIC has.
+#define PORT_CHECKS_(name, u, peer, g, rx, tx, bt, ct, gt, rxDma, txDma)   \
+  _Static_assert(((GPIO_P##g##rx##_U##u##RX >> 16) & 0xff)              \
+    == PORT_GPIO_INDEX_##g && ((GPIO_P##g##rx##_U##u##RX >> 8) & 0xff)  \
+    == 4 * (rx), "UART" #u " RX is not muxed to P" #g #rx);             \
+  _Static_assert(((GPIO_P##g##tx##_U##u##TX >> 16) & 0xff)              \
+    == PORT_GPIO_INDEX_##g && ((GPIO_P##g##tx##_U##u##TX >> 8) & 0xff)  \
+    == 4 * (tx), "UART" #u " TX is not muxed to P" #g #tx);             \
+  _Static_assert((UDMA_CH##rxDma##_UART##u##RX & 0xff) == (rxDma),      \
+    "UART" #u " RX is not on DMA channel " #rxDma);                     \
+  _Static_assert((UDMA_CH##txDma##_UART##u##TX & 0xff) == (txDma),      \
+    "UART" #u " TX is not on DMA channel " #txDma);                     \
+  _Static_assert(INT_UART##u < NUM_INTERRUPTS                           \
+    && INT_TIMER##bt##A < NUM_INTERRUPTS                                \
+    && INT_TIMER##ct##A < NUM_INTERRUPTS                                \
+    && INT_TIMER##gt##A < NUM_INTERRUPTS,                               \
+    "port " #name " has an interrupt the NVIC doesn't");                \
+  _Static_assert((peer) != (u), "port " #name " forwards to itself");
+
+#define PORT_CHECKS(port) PORT_APPLY(PORT_CHECKS_, port)
+
+BRIDGE_PORTS(PORT_CHECKS)
+
+// No UART, timer or DMA channel may belong to two ports, or be put to two
+// uses by one. The bits of the resources add up to their union only if none
+// is taken twice.
+#define PORT_UART_SUM_(name, u, peer, g, rx, tx, bt, ct, gt, rxDma, txDma) \
+  + (1ull << (u))
+#define PORT_UART_OR_(name, u, peer, g, rx, tx, bt, ct, gt, rxDma, txDma) \
+  | (1ull << (u))
+#define PORT_TIMER_SUM_(name, u, peer, g, rx, tx, bt, ct, gt, rxDma, txDma) \
+  + (1ull << (bt)) + (1ull << (ct)) + (1ull << (gt))
+#define PORT_TIMER_OR_(name, u, peer, g, rx, tx, bt, ct, gt, rxDma, txDma) \
+  | (1ull << (bt)) | (1ull << (ct)) | (1ull << (gt))
+#define PORT_DMA_SUM_(name, u, peer, g, rx, tx, bt, ct, gt, rxDma, txDma) \
+  + (1ull << (rxDma)) + (1ull << (txDma))
+#define PORT_DMA_OR_(name, u, peer, g, rx, tx, bt, ct, gt, rxDma, txDma) \
+  | (1ull << (rxDma)) | (1ull << (txDma))
+
+#define PORT_UART_SUM(port) PORT_APPLY(PORT_UART_SUM_, port)
+#define PORT_UART_OR(port) PORT_APPLY(PORT_UART_OR_, port)
+#define PORT_TIMER_SUM(port) PORT_APPLY(PORT_TIMER_SUM_, port)
+#define PORT_TIMER_OR(port) PORT_APPLY(PORT_TIMER_OR_, port)
+#define PORT_DMA_SUM(port) PORT_APPLY(PORT_DMA_SUM_, port)
+#define PORT_DMA_OR(port) PORT_APPLY(PORT_DMA_OR_, port)
+
+_Static_assert((0 BRIDGE_PORTS(PORT_UART_SUM))
+  == (0 BRIDGE_PORTS(PORT_UART_OR)), "a UART is used by two ports");
+_Static_assert((0 BRIDGE_PORTS(PORT_TIMER_SUM))
+  == (0 BRIDGE_PORTS(PORT_TIMER_OR)), "a timer is used twice");
+_Static_assert((0 BRIDGE_PORTS(PORT_DMA_SUM))
+  == (0 BRIDGE_PORTS(PORT_DMA_OR)), "a DMA channel is used twice");
+
+/******************************************************************************
+ * HANDLERS
+ ***/
+
+#define PORT_DECLARE_HANDLERS_(name, u, peer, g, rx, tx, bt, ct, gt, rxDma, \
+  txDma)                                                                \
+  void UART##name##Handler(void);                                       \
+  void BreakTimer##name##Handler(void);                                 \
+  void CoalesceTimer##name##Handler(void);                              \
+  void GapTimer##name##Handler(void);                                   \
+  void Bert##name##Handler(void);
+
+#define PORT_DECLARE_HANDLERS(port) PORT_APPLY(PORT_DECLARE_HANDLERS_, port)
+
+#define PORT_UART_HANDLER_(name, u, peer, g, rx, tx, bt, ct, gt, rxDma, \
+  txDma)                                                                \
+  void UART##name##Handler(void) {                                      \
+    MARKER_HIGH(MARKER_UART##u);                                        \
+    GenericUARTIntHandler(&uart##u, &uart##peer);                       \
+    MARKER_LOW(MARKER_UART##u);                                         \
+  }
+
+#define PORT_UART_HANDLER(port) PORT_APPLY(PORT_UART_HANDLER_, port)
+
+#define PORT_BREAK_HANDLER_(name, u, peer, g, rx, tx, bt, ct, gt, rxDma, \
+  txDma)                                                                \
+  void BreakTimer##name##Handler(void) {                                \
+    GenericBreakTimerHandler(&uart##u, &uart##peer);                    \
+  }
+
+#define PORT_BREAK_HANDLER(port) PORT_APPLY(PORT_BREAK_HANDLER_, port)
+
+#define PORT_COALESCE_HANDLER_(name, u, peer, g, rx, tx, bt, ct, gt, rxDma, \
+  txDma)                                                                \
+  void CoalesceTimer##name##Handler(void) {                             \
+    GenericCoalesceTimerHandler(&uart##u);                              \
+  }
+
+#define PORT_COALESCE_HANDLER(port) PORT_APPLY(PORT_COALESCE_HANDLER_, port)
+
+#define PORT_GAP_HANDLER_(name, u, peer, g, rx, tx, bt, ct, gt, rxDma, \
+  txDma)                                                                \
+  void GapTimer##name##Handler(void) {                                  \
+    GenericGapTimerHandler(&uart##u, &uart##peer);                      \
+  }
+
+#define PORT_GAP_HANDLER(port) PORT_APPLY(PORT_GAP_HANDLER_, port)
+
+#define PORT_BERT_HANDLER_(name, u, peer, g, rx, tx, bt, ct, gt, rxDma, \
+  txDma)                                                                \
+  void Bert##name##Handler(void) {                                      \
+    GenericBertHandler(&uart##u);                                       \
+  }
+
+#define PORT_BERT_HANDLER(port) PORT_APPLY(PORT_BERT_HANDLER_, port)
+
+/******************************************************************************
+ * FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        PortCharsAvail
+ *
+ * DESCRIPTION:     UARTCharsAvail(), inlined.
+ ***/
+PORT_INLINE bool PortCharsAvail(uint32_t base)
+{
+  return !(HWREG(base + UART_O_FR) & UART_FR_RXFE);
+}
+
+/******************************************************************************
+ * FUNCTION:        PortSpaceAvail
+ *
+ * DESCRIPTION:     UARTSpaceAvail(), inlined.
+ ***/
+PORT_INLINE bool PortSpaceAvail(uint32_t base)
+{
+  return !(HWREG(base + UART_O_FR) & UART_FR_TXFF);
+}
+
+/******************************************************************************
+ * FUNCTION:        PortCharGet
+ *
+ * DESCRIPTION:     Read the data register: the oldest char in the RX FIFO,
+ *                  with its error bits (UART_DR_*) above it. Only call this
+ *                  when PortCharsAvail() says there's one.
+ ***/
+PORT_INLINE uint32_t PortCharGet(uint32_t base)
+{
+  return HWREG(base + UART_O_DR);
+}
+
+/******************************************************************************
+ * FUNCTION:        PortCharPut
+ *
+ * DESCRIPTION:     UARTCharPutNonBlocking(), inlined.
+ *
+ * RETURNS:         false if the TX FIFO was full, and the char wasn't sent.
+ ***/
+PORT_INLINE bool PortCharPut(uint32_t base, uint8_t c)
+{
+  if (HWREG(base + UART_O_FR) & UART_FR_TXFF) {
+    return false;
+  }
+
+  HWREG(base + UART_O_DR) = c;
+  return true;
+}
+
+/******************************************************************************
+ * FUNCTION:        PortIntStatus
+ *
+ * DESCRIPTION:     UARTIntStatus(), inlined.
+ ***/
+PORT_INLINE uint32_t PortIntStatus(uint32_t base, bool masked)
+{
+  return HWREG(base + (masked ? UART_O_MIS : UART_O_RIS));
+}
+
+/******************************************************************************
+ * FUNCTION:        PortIntClear
+ *
+ * DESCRIPTION:     UARTIntClear(), inlined.
+ ***/
+PORT_INLINE void PortIntClear(uint32_t base, uint32_t ints)
+{
+  HWREG(base + UART_O_ICR) = ints;
+}
+
+#endif // PORTS_H
+
+/*****************************************************************************/
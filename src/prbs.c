@@ -0,0 +1,253 @@
+/******************************************************************************
+ * NAME:	    prbs.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    PRBS generator and self-synchronizing checker. See prbs.h
+ *                  for the sequences and how the checker keeps its lock.
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "prbs.h"
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        Load
+ *
+ * DESCRIPTION:     Shift the 8 bits of `c' into the LFSR, as if the
+ *                  generator had produced them.
+ ***/
+static inline void Load(prbs_t* prbs, uint8_t c)
+{
+  for (uint32_t i = 0; i < 8; ++i) {
+    prbs->state = ((prbs->state << 1) | ((c >> i) & 1)) & prbs->mask;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:        BitsSet
+ *
+ * DESCRIPTION:     Number of bits set in `c'. The M4 has no instruction for
+ *                  this, and this is shorter than the libgcc call.
+ ***/
+static inline uint32_t BitsSet(uint8_t c)
+{
+  c = (uint8_t)(c - ((c >> 1) & 0x55));
+  c = (uint8_t)((c & 0x33) + ((c >> 2) & 0x33));
+  return (c + (c >> 4)) & 0x0f;
+}
+
+/******************************************************************************
+ * FUNCTION:        ClassifyLoss
+ *
+ * DESCRIPTION:     On locking again after a loss, count a slip if the new
+ *                  lock is a few chars ahead of or behind where the old one
+ *                  would be now. If it's exactly there, the loss was a burst
+ *                  of errors, and if it's further away than PRBS_MAX_SLIP,
+ *                  there's no telling.
+ ***/
+static void ClassifyLoss(prbs_checker_t* checker)
+{
+  const uint32_t now = checker->expected.state;
+  const uint32_t then = checker->reference.state;
+  if (now == then) {
+    return;
+  }
+
+  prbs_t ahead = checker->reference;
+  prbs_t behind = checker->expected;
+  for (uint32_t slip = 1; slip <= PRBS_MAX_SLIP; ++slip) {
+    PrbsNext(&ahead);
+    if (ahead.state == now) {
+      checker->slips++;
+      checker->charsLost += slip;
+      return;
+    }
+
+    PrbsNext(&behind);
+    if (behind.state == then) {
+      checker->slips++;
+      checker->charsGained += slip;
+      return;
+    }
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:        Acquire
+ *
+ * DESCRIPTION:     Load the LFSR from the received chars, and lock once
+ *                  PRBS_SYNC_CHARS more have matched it.
+ ***/
+static void Acquire(prbs_checker_t* checker, uint8_t c)
+{
+  if (checker->lost) {
+    PrbsNext(&checker->reference);
+  }
+
+  if (checker->loaded < checker->expected.order) {
+    Load(&checker->expected, c);
+    checker->loaded += 8;
+    return;
+  }
+
+  const uint32_t state = checker->expected.state;
+  if (PrbsNext(&checker->expected) != c) {
+    // Start over from this char.
+    checker->expected.state = state;
+    Load(&checker->expected, c);
+    checker->loaded = 8;
+    checker->matched = 0;
+    return;
+  }
+
+  if (++checker->matched < PRBS_SYNC_CHARS) {
+    return;
+  }
+
+  checker->locked = true;
+  checker->locks++;
+  memset(checker->errors, 0, sizeof(checker->errors));
+  checker->index = 0;
+  checker->filled = 0;
+  checker->windowErrors = 0;
+  checker->windowErrored = 0;
+  if (checker->lost) {
+    ClassifyLoss(checker);
+    checker->lost = false;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:        LoseLock
+ *
+ * DESCRIPTION:     Drop the lock, and take back what was counted for the
+ *                  chars in the window, which were most likely checked
+ *                  against the wrong part of the sequence.
+ ***/
+static void LoseLock(prbs_checker_t* checker)
+{
+  checker->bitErrors -= checker->windowErrors;
+  checker->bitsChecked -= 8 * checker->filled;
+  checker->resyncs++;
+
+  // Where the expected sequence goes from here is where the old lock would
+  // be, had the line only taken errors.
+  checker->reference = checker->expected;
+  checker->lost = true;
+  checker->locked = false;
+  checker->loaded = 0;
+  checker->matched = 0;
+}
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        PrbsInit
+ *
+ * DESCRIPTION:     Start a generator at the beginning of the sequence (all
+ *                  ones in the LFSR).
+ *
+ * ARGUMENTS:       pattern: 7, 15 or 31.
+ *
+ * RETURNS:         False if the pattern isn't one of those.
+ ***/
+bool PrbsInit(prbs_t* prbs, uint32_t pattern)
+{
+  switch (pattern) {
+  case 7: prbs->tap = 6; break;
+  case 15: prbs->tap = 14; break;
+  case 31: prbs->tap = 28; break;
+  default: return false;
+  }
+
+  prbs->order = (uint8_t)pattern;
+  prbs->mask = (uint32_t)((1ULL << pattern) - 1);
+  prbs->state = prbs->mask;
+  return true;
+}
+
+/******************************************************************************
+ * FUNCTION:        PrbsNext
+ *
+ * DESCRIPTION:     The next 8 bits of the sequence, the first in bit 0.
+ ***/
+uint8_t PrbsNext(prbs_t* prbs)
+{
+  const uint32_t order = prbs->order - 1;
+  const uint32_t tap = prbs->tap - 1;
+  uint32_t state = prbs->state;
+  uint8_t c = 0;
+
+  for (uint32_t i = 0; i < 8; ++i) {
+    const uint32_t bit = ((state >> order) ^ (state >> tap)) & 1;
+    state = ((state << 1) | bit) & prbs->mask;
+    c |= (uint8_t)(bit << i);
+  }
+
+  prbs->state = state;
+  return c;
+}
+
+/******************************************************************************
+ * FUNCTION:        PrbsCheckerInit
+ *
+ * DESCRIPTION:     Reset the checker and its statistics, and start looking
+ *                  for the sequence.
+ *
+ * RETURNS:         False if the pattern isn't supported.
+ ***/
+bool PrbsCheckerInit(prbs_checker_t* checker, uint32_t pattern)
+{
+  memset(checker, 0, sizeof(*checker));
+  return PrbsInit(&checker->expected, pattern)
+    && PrbsInit(&checker->reference, pattern);
+}
+
+/******************************************************************************
+ * FUNCTION:        PrbsCheck
+ *
+ * DESCRIPTION:     Check one received char.
+ ***/
+void PrbsCheck(prbs_checker_t* checker, uint8_t c)
+{
+  checker->chars++;
+  if (!checker->locked) {
+    Acquire(checker, c);
+    return;
+  }
+
+  const uint32_t errors = BitsSet(PrbsNext(&checker->expected) ^ c);
+  const uint32_t slot = checker->index;
+  const uint32_t previous = checker->errors[slot];
+  checker->windowErrors += errors - previous;
+  checker->windowErrored += (0 != errors) - (0 != previous);
+  checker->errors[slot] = (uint8_t)errors;
+  checker->index = (slot + 1) % PRBS_WINDOW;
+  if (checker->filled < PRBS_WINDOW) {
+    checker->filled++;
+  }
+
+  checker->bitErrors += errors;
+  checker->bitsChecked += 8;
+  if (checker->windowErrored >= PRBS_LOSS_CHARS) {
+    LoseLock(checker);
+  }
+}
+
+/*****************************************************************************/
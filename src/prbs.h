@@ -0,0 +1,106 @@
+/******************************************************************************
+ * NAME:	    prbs.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    PRBS7, PRBS15 and PRBS31 generator and checker for the
+ *                  bit-error-rate tester. The sequences are the ITU-T O.150
+ *                  polynomials x^7+x^6+1, x^15+x^14+1 and x^31+x^28+1 (not
+ *                  inverted), sent least significant bit first, as a UART
+ *                  does, so each char carries the next 8 bits of the
+ *                  sequence.
+ *
+ *                  The checker synchronizes itself from the received
+ *                  stream: it loads the first `order' bits it sees into its
+ *                  LFSR, and locks once the chars after them match. While
+ *                  locked it predicts every char, so an error counts once
+ *                  and does not spread. When most of the recent chars are
+ *                  wrong it drops the lock, takes back the errors it counted
+ *                  in that stretch (they were a symptom, not the line) and
+ *                  starts over. On locking again it compares where the new
+ *                  lock sits in the sequence with where the old one would
+ *                  have been, which tells a slip (chars dropped or added,
+ *                  as from a FIFO overrun) from a burst of errors.
+ *
+ *                  The module has no hardware dependencies, so the host end
+ *                  (tools/bert.c) runs the same code.
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+#ifndef PRBS_H
+#define PRBS_H
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// The checker drops the lock when PRBS_LOSS_CHARS of the last
+// PRBS_WINDOW chars were wrong. Random data gets almost every char wrong,
+// while even a bit error rate of 1e-2 gets fewer than 1 in 10 wrong.
+#define PRBS_WINDOW         16
+#define PRBS_LOSS_CHARS     8
+// Error-free chars after the loaded ones before the checker locks.
+#define PRBS_SYNC_CHARS     4
+// Largest slip, in chars, that the checker can measure.
+#define PRBS_MAX_SLIP       32
+
+typedef struct {
+
+  // The last `order' bits of the sequence, the newest in bit 0.
+  uint32_t state;
+  uint32_t mask;
+  uint8_t order;
+  uint8_t tap;
+
+} prbs_t;
+
+typedef struct {
+
+  prbs_t expected;
+  bool locked;
+  // Acquiring: bits loaded, and chars matched since.
+  uint32_t loaded;
+  uint32_t matched;
+
+  // Locked: bit errors in each of the last PRBS_WINDOW chars.
+  uint8_t errors[PRBS_WINDOW];
+  uint32_t index;
+  uint32_t filled;
+  uint32_t windowErrors;
+  uint32_t windowErrored;
+
+  // Acquiring after a loss: where the old lock would be now.
+  prbs_t reference;
+  bool lost;
+
+  // Statistics. The bit error rate is bitErrors over bitsChecked. Chars
+  // received while acquiring are not checked.
+  uint64_t chars;
+  uint64_t bitsChecked;
+  uint64_t bitErrors;
+  uint32_t locks;
+  uint32_t resyncs;
+  uint32_t slips;
+  uint32_t charsLost;
+  uint32_t charsGained;
+
+} prbs_checker_t;
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+bool PrbsInit(prbs_t* prbs, uint32_t pattern);
+uint8_t PrbsNext(prbs_t* prbs);
+bool PrbsCheckerInit(prbs_checker_t* checker, uint32_t pattern);
+void PrbsCheck(prbs_checker_t* checker, uint8_t c);
+
+#endif // PRBS_H
+
+/*****************************************************************************/
@@ -0,0 +1,299 @@
+/******************************************************************************
+ * NAME:	    ringbuf.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Lock-free single-producer/single-consumer ring buffer.
+ *                  The producer (typically an ISR) only ever writes `head',
+ *                  and the consumer only ever writes `tail', so neither side
+ *                  needs to mask interrupts. Indices are free-running 32-bit
+ *                  counters reduced with a power-of-two mask, so `head - tail'
+ *                  is always the fill level, even across wrap-around.
+ *
+ *                  In addition to byte-at-a-time access, the buffer hands out
+ *                  contiguous spans for bulk reads and writes, so callers can
+ *                  memcpy or DMA directly into and out of the storage.
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+#ifndef RINGBUF_H
+#define RINGBUF_H
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Orders the data accesses against the index update. On the Cortex-M4 the
+// core itself won't reorder these, but the compiler might, and the DMB keeps
+// the buffer coherent with the uDMA controller as well.
+#if defined(__arm__)
+#define RING_BARRIER() asm volatile ("dmb" ::: "memory")
+#else
+#define RING_BARRIER() __sync_synchronize()
+#endif
+
+// Declare the backing storage for a ring. Size must be a power of two.
+#define RING_STORAGE(name, size)                                        \
+  _Static_assert((size) != 0 && ((size) & ((size) - 1)) == 0,           \
+    #name ": ring size must be a power of two");                        \
+  static uint8_t name[(size)]
+
+typedef struct {
+
+  volatile uint32_t head;
+  volatile uint32_t tail;
+  uint32_t mask;
+  uint8_t* buffer;
+
+} ringbuf_t;
+
+/******************************************************************************
+ * FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        RingInit
+ *
+ * DESCRIPTION:     Initialize a ring over `storage'. Must be called before
+ *                  either side touches the ring.
+ *
+ * ARGUMENTS:       ring: The ring to initialize
+ *                  storage: Backing storage (see RING_STORAGE)
+ *                  size: Size of storage, in bytes. Must be a power of two.
+ ***/
+static inline void RingInit(ringbuf_t* ring, uint8_t* storage, uint32_t size)
+{
+  ring->head = 0;
+  ring->tail = 0;
+  ring->mask = size - 1;
+  ring->buffer = storage;
+}
+
+/******************************************************************************
+ * FUNCTION:        RingCount
+ *
+ * DESCRIPTION:     Number of bytes currently queued. Safe to call from either
+ *                  side; the result is a lower bound for the consumer and an
+ *                  upper bound for the producer.
+ ***/
+static inline uint32_t RingCount(const ringbuf_t* ring)
+{
+  return ring->head - ring->tail;
+}
+
+/******************************************************************************
+ * FUNCTION:        RingSpace
+ *
+ * DESCRIPTION:     Number of bytes that can be pushed without overwriting.
+ ***/
+static inline uint32_t RingSpace(const ringbuf_t* ring)
+{
+  return ring->mask + 1 - (ring->head - ring->tail);
+}
+
+/******************************************************************************
+ * FUNCTION:        RingPush
+ *
+ * DESCRIPTION:     Producer side. Push one byte.
+ *
+ * RETURNS:         false if the ring was full and the byte was not queued.
+ ***/
+static inline bool RingPush(ringbuf_t* ring, uint8_t c)
+{
+  uint32_t head = ring->head;
+  if (head - ring->tail > ring->mask) {
+    return false;
+  }
+
+  ring->buffer[head & ring->mask] = c;
+  RING_BARRIER();
+  ring->head = head + 1;
+  return true;
+}
+
+/******************************************************************************
+ * FUNCTION:        RingPop
+ *
+ * DESCRIPTION:     Consumer side. Pop one byte.
+ *
+ * RETURNS:         false if the ring was empty.
+ ***/
+static inline bool RingPop(ringbuf_t* ring, uint8_t* c)
+{
+  uint32_t tail = ring->tail;
+  if (ring->head == tail) {
+    return false;
+  }
+
+  RING_BARRIER();
+  *c = ring->buffer[tail & ring->mask];
+  RING_BARRIER();
+  ring->tail = tail + 1;
+  return true;
+}
+
+/******************************************************************************
+ * FUNCTION:        RingWriteSpan
+ *
+ * DESCRIPTION:     Producer side. Get the largest contiguous free region of
+ *                  the ring. Fill some prefix of it, then publish it with
+ *                  RingWriteCommit. When the free space wraps around the end
+ *                  of the storage, only the part up to the end is returned;
+ *                  call again after committing to get the rest.
+ *
+ * ARGUMENTS:       span: Receives a pointer to the start of the region.
+ *
+ * RETURNS:         Length of the region, in bytes.
+ ***/
+static inline uint32_t RingWriteSpan(ringbuf_t* ring, uint8_t** span)
+{
+  uint32_t head = ring->head;
+  uint32_t offset = head & ring->mask;
+  uint32_t space = ring->mask + 1 - (head - ring->tail);
+  uint32_t toEnd = ring->mask + 1 - offset;
+
+  *span = &ring->buffer[offset];
+  return space < toEnd ? space : toEnd;
+}
+
+/******************************************************************************
+ * FUNCTION:        RingWriteCommit
+ *
+ * DESCRIPTION:     Producer side. Publish `count' bytes written into the span
+ *                  returned by RingWriteSpan.
+ ***/
+static inline void RingWriteCommit(ringbuf_t* ring, uint32_t count)
+{
+  RING_BARRIER();
+  ring->head += count;
+}
+
+/******************************************************************************
+ * FUNCTION:        RingReadSpan
+ *
+ * DESCRIPTION:     Consumer side. Get the largest contiguous run of queued
+ *                  bytes. Consume some prefix of it, then release it with
+ *                  RingReadCommit. As with RingWriteSpan, a run that wraps is
+ *                  returned in two calls.
+ *
+ * ARGUMENTS:       span: Receives a pointer to the first queued byte.
+ *
+ * RETURNS:         Length of the run, in bytes.
+ ***/
+static inline uint32_t RingReadSpan(ringbuf_t* ring, const uint8_t** span)
+{
+  uint32_t tail = ring->tail;
+  uint32_t offset = tail & ring->mask;
+  uint32_t count = ring->head - tail;
+  uint32_t toEnd = ring->mask + 1 - offset;
+
+  RING_BARRIER();
+  *span = &ring->buffer[offset];
+  return count < toEnd ? count : toEnd;
+}
+
+/******************************************************************************
+ * FUNCTION:        RingPeekSpan
+ *
+ * DESCRIPTION:     Consumer side. Like RingReadSpan, but starting `offset'
+ *                  bytes past the first queued byte, so that the consumer can
+ *                  look ahead without consuming anything.
+ *
+ * ARGUMENTS:       offset: Number of queued bytes to skip. Must not exceed
+ *                          RingCount().
+ *                  span: Receives a pointer to the first byte after `offset'.
+ *
+ * RETURNS:         Length of the run, in bytes.
+ ***/
+static inline uint32_t RingPeekSpan(ringbuf_t* ring, uint32_t offset,
+  const uint8_t** span)
+{
+  uint32_t start = ring->tail + offset;
+  uint32_t index = start & ring->mask;
+  uint32_t count = ring->head - start;
+  uint32_t toEnd = ring->mask + 1 - index;
+
+  RING_BARRIER();
+  *span = &ring->buffer[index];
+  return count < toEnd ? count : toEnd;
+}
+
+/******************************************************************************
+ * FUNCTION:        RingReadCommit
+ *
+ * DESCRIPTION:     Consumer side. Release `count' bytes of the span returned
+ *                  by RingReadSpan back to the producer.
+ ***/
+static inline void RingReadCommit(ringbuf_t* ring, uint32_t count)
+{
+  RING_BARRIER();
+  ring->tail += count;
+}
+
+/******************************************************************************
+ * FUNCTION:        RingPushBulk
+ *
+ * DESCRIPTION:     Producer side. Copy up to `length' bytes into the ring.
+ *
+ * RETURNS:         Number of bytes actually queued.
+ ***/
+static inline uint32_t RingPushBulk(ringbuf_t* ring, const uint8_t* data,
+  uint32_t length)
+{
+  uint32_t total = 0;
+  uint8_t* span = NULL;
+  uint32_t n = 0;
+
+  // At most two spans: up to the end of storage, then from the start.
+  for (int i = 0; i < 2 && total < length; ++i) {
+    if (0 == (n = RingWriteSpan(ring, &span))) {
+      break;
+    }
+
+    n = n < length - total ? n : length - total;
+    memcpy(span, data + total, n);
+    RingWriteCommit(ring, n);
+    total += n;
+  }
+
+  return total;
+}
+
+/******************************************************************************
+ * FUNCTION:        RingPopBulk
+ *
+ * DESCRIPTION:     Consumer side. Copy up to `length' bytes out of the ring.
+ *
+ * RETURNS:         Number of bytes actually dequeued.
+ ***/
+static inline uint32_t RingPopBulk(ringbuf_t* ring, uint8_t* data,
+  uint32_t length)
+{
+  uint32_t total = 0;
+  const uint8_t* span = NULL;
+  uint32_t n = 0;
+
+  for (int i = 0; i < 2 && total < length; ++i) {
+    if (0 == (n = RingReadSpan(ring, &span))) {
+      break;
+    }
+
+    n = n < length - total ? n : length - total;
+    memcpy(data + total, span, n);
+    RingReadCommit(ring, n);
+    total += n;
+  }
+
+  return total;
+}
+
+#endif // RINGBUF_H
+
+/*****************************************************************************/
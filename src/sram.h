@@ -0,0 +1,61 @@
+/******************************************************************************
+ * NAME:	    sram.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    SRAM accounting. The linker script holds each part of
+ *                  SRAM (vtable, .data, .bss, buffers, stack and no-init) to
+ *                  a budget, and fails the link if one is over. Variables
+ *                  marked SRAM_BUFFER count against the buffer budget instead
+ *                  of .bss, and those marked SRAM_NOINIT are never cleared.
+ *                  The stack is painted at reset, so its high-water mark can
+ *                  be read at any time after.
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+#ifndef SRAM_H
+#define SRAM_H
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stdint.h>
+
+// Size of the system stack, in bytes.
+#ifndef CONFIG_STACK_SIZE
+#define CONFIG_STACK_SIZE 512
+#endif
+
+// Zeroed like .bss, but counted against the buffer budget. Each buffer gets
+// a section of its own, named after it, like -fdata-sections would give it.
+#define SRAM_BUFFER(name) __attribute__((section(".bss.buffers." #name)))
+
+// Never initialized, so it keeps its contents across a reset, and is random
+// after a power cycle. Placed at the very end of SRAM, where it stays put
+// from one build to the next.
+#define SRAM_NOINIT(name) __attribute__((section(".noinit." #name)))
+
+/******************************************************************************
+ * FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        StackHighWater
+ *
+ * DESCRIPTION:     Find the most stack used since reset, from the deepest
+ *                  word that no longer holds the paint. Defined in
+ *                  startup_gcc.c. Can be called from a debugger:
+ *
+ *                    (gdb) print StackHighWater()
+ *
+ * RETURNS:         Bytes of the CONFIG_STACK_SIZE-byte stack used.
+ ***/
+uint32_t StackHighWater(void);
+
+#endif // SRAM_H
+
+/*****************************************************************************/
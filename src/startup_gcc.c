@@ -25,6 +25,9 @@
 #include <stdint.h>
 #include "inc/hw_nvic.h"
 #include "inc/hw_types.h"
+#include "boot.h"
+#include "cycles.h"
+#include "sram.h"
 
 //*****************************************************************************
 //
@@ -45,18 +48,29 @@ extern int main(void);
 
 //*****************************************************************************
 //
-// Reserve space for the system stack.
+// Reserve space for the system stack.  It has a section of its own, outside
+// .bss, so that it can be painted before .bss is zeroed.  The top must be
+// 8-byte aligned.
 //
 //*****************************************************************************
-static uint32_t pui32Stack[128];
+__attribute__ ((section(".stack"), aligned(8)))
+static uint32_t pui32Stack[CONFIG_STACK_SIZE / 4];
+
+//*****************************************************************************
+//
+// The value the stack is filled with at reset.
+//
+//*****************************************************************************
+#define STACK_PAINT             0xC5C5C5C5
 
 //*****************************************************************************
 //
 // The vector table.  Note that the proper constructs must be placed on this to
-// ensure that it ends up at physical address 0x0000.0000.
+// ensure that it ends up at physical address 0x0000.0000.  Nothing refers to
+// it but the linker script, so it's marked used to survive LTO.
 //
 //*****************************************************************************
-__attribute__ ((section(".isr_vector")))
+__attribute__ ((section(".isr_vector"), used))
 void (* const g_pfnVectors[])(void) =
 {
     (void (*)(void))((uint32_t)pui32Stack + sizeof(pui32Stack)),
@@ -245,29 +259,91 @@ ResetISR(void)
 {
     // TODO: Allow the application to work after reboot
     // (without having to reprogram every time)
-    uint32_t *pui32Src, *pui32Dest;
+    uint32_t ui32Painted, ui32Copied;
+
+    //
+    // Start the cycle counter, which timestamps the stages of the boot.
+    //
+    CyclesInit();
+
+    //
+    // Paint the stack below the stack pointer, for StackHighWater().  Each of
+    // these loops moves four words per iteration with ldm/stm, then finishes
+    // one word at a time.
+    //
+    __asm volatile("    ldr     r0, =_stack\n"
+                   "    mov     r1, sp\n"
+                   "    mov     r2, %0\n"
+                   "    mov     r3, %0\n"
+                   "    mov     r4, %0\n"
+                   "    mov     r5, %0\n"
+                   "    sub     ip, r1, #16\n"
+                   "paint_block:\n"
+                   "        cmp     r0, ip\n"
+                   "        bhi     paint_word\n"
+                   "        stmia   r0!, {r2-r5}\n"
+                   "        b       paint_block\n"
+                   "paint_word:\n"
+                   "        cmp     r0, r1\n"
+                   "        it      lo\n"
+                   "        strlo   r2, [r0], #4\n"
+                   "        blo     paint_word"
+                   : : "r" (STACK_PAINT)
+                   : "r0", "r1", "r2", "r3", "r4", "r5", "ip", "cc", "memory");
+    ui32Painted = CyclesNow();
 
     //
     // Copy the data segment initializers from flash to SRAM.
     //
-    pui32Src = &_ldata;
-    for(pui32Dest = &_data; pui32Dest < &_edata; )
-    {
-        *pui32Dest++ = *pui32Src++;
-    }
+    __asm volatile("    ldr     r0, =_ldata\n"
+                   "    ldr     r1, =_data\n"
+                   "    ldr     r2, =_edata\n"
+                   "    sub     ip, r2, #16\n"
+                   "copy_block:\n"
+                   "        cmp     r1, ip\n"
+                   "        bhi     copy_word\n"
+                   "        ldmia   r0!, {r3-r6}\n"
+                   "        stmia   r1!, {r3-r6}\n"
+                   "        b       copy_block\n"
+                   "copy_word:\n"
+                   "        cmp     r1, r2\n"
+                   "        itt     lo\n"
+                   "        ldrlo   r3, [r0], #4\n"
+                   "        strlo   r3, [r1], #4\n"
+                   "        blo     copy_word"
+                   : : : "r0", "r1", "r2", "r3", "r4", "r5", "r6", "ip", "cc",
+                         "memory");
+    ui32Copied = CyclesNow();
 
     //
     // Zero fill the bss segment.
     //
-    __asm("    ldr     r0, =_bss\n"
-          "    ldr     r1, =_ebss\n"
-          "    mov     r2, #0\n"
-          "    .thumb_func\n"
-          "zero_loop:\n"
-          "        cmp     r0, r1\n"
-          "        it      lt\n"
-          "        strlt   r2, [r0], #4\n"
-          "        blt     zero_loop");
+    __asm volatile("    ldr     r0, =_bss\n"
+                   "    ldr     r1, =_ebss\n"
+                   "    mov     r2, #0\n"
+                   "    mov     r3, #0\n"
+                   "    mov     r4, #0\n"
+                   "    mov     r5, #0\n"
+                   "    sub     ip, r1, #16\n"
+                   "zero_block:\n"
+                   "        cmp     r0, ip\n"
+                   "        bhi     zero_word\n"
+                   "        stmia   r0!, {r2-r5}\n"
+                   "        b       zero_block\n"
+                   "zero_word:\n"
+                   "        cmp     r0, r1\n"
+                   "        it      lo\n"
+                   "        strlo   r2, [r0], #4\n"
+                   "        blo     zero_word"
+                   : : : "r0", "r1", "r2", "r3", "r4", "r5", "ip", "cc",
+                         "memory");
+
+    //
+    // Only now can the timestamps be kept in .bss.
+    //
+    g_boot.cycles[BOOT_STACK_PAINTED] = ui32Painted;
+    g_boot.cycles[BOOT_DATA_COPIED] = ui32Copied;
+    g_boot.cycles[BOOT_BSS_ZEROED] = CyclesNow();
 
     //
     // Enable the floating-point unit.  This must be done here to handle the
@@ -279,7 +355,17 @@ ResetISR(void)
     // Note that this does not use DriverLib since it might not be included in
     // this project.
     //
-    HWREG(NVIC_CPAC) = ((HWREG(NVIC_CPAC) &
+    // No interrupt handler uses the floating-point unit, so unless
+    // CONFIG_FPU_ISR is set, exceptions are told not to preserve its state.
+    // Every exception then stacks the basic 8-word frame, whatever the
+    // interrupted code was doing, instead of reserving the 26-word frame
+    // whenever thread mode has touched the FPU.  `make fpucheck' looks for
+    // FPU instructions in the image.
+    //
+#ifndef CONFIG_FPU_ISR
+    HWREG(NVIC_FPCC) &= ~(NVIC_FPCC_ASPEN | NVIC_FPCC_LSPEN);
+#endif
+    HWREG(NVIC_CPAC) =((HWREG(NVIC_CPAC) &
                          ~(NVIC_CPAC_CP10_M | NVIC_CPAC_CP11_M)) |
                         NVIC_CPAC_CP10_FULL | NVIC_CPAC_CP11_FULL);
 
@@ -291,38 +377,68 @@ ResetISR(void)
 
 //*****************************************************************************
 //
-// This is the code that gets called when the processor receives a NMI.  This
-// simply enters an infinite loop, preserving the system state for examination
-// by a debugger.
+// Report the most stack used since reset.  The stack grows down, so the words
+// still holding the paint at its bottom have never been used.  Only a
+// debugger calls this, so it's kept by the linker script, and marked used to
+// survive LTO.
 //
 //*****************************************************************************
-static void
-NmiSR(void)
+__attribute__ ((used))
+uint32_t
+StackHighWater(void)
 {
-    //
-    // Enter an infinite loop.
-    //
-    while(1)
+    uint32_t ui32Unused = 0;
+
+    while((ui32Unused < sizeof(pui32Stack) / 4) &&
+          (pui32Stack[ui32Unused] == STACK_PAINT))
     {
+        ui32Unused++;
     }
+
+    return(sizeof(pui32Stack) - 4 * ui32Unused);
+}
+
+//*****************************************************************************
+//
+// Hand the crash to CrashCapture() (see crash.h), with the stack frame the
+// exception pushed, the exception return value, and r4-r11, which are pushed
+// here since the exception doesn't.  CrashCapture() never returns.
+//
+//*****************************************************************************
+#define CRASH_CAPTURE                                                         \
+    __asm volatile("        tst     lr, #4\n"                                 \
+                   "        ite     eq\n"                                     \
+                   "        mrseq   r0, msp\n"                                \
+                   "        mrsne   r0, psp\n"                                \
+                   "        mov     r1, lr\n"                                 \
+                   "        push    {r4-r11}\n"                               \
+                   "        mov     r2, sp\n"                                 \
+                   "        b       CrashCapture")
+
+//*****************************************************************************
+//
+// This is the code that gets called when the processor receives a NMI.  The
+// crash is recorded and the processor reset (see crash.h).
+//
+//*****************************************************************************
+__attribute__ ((naked))
+static void
+NmiSR(void)
+{
+    CRASH_CAPTURE;
 }
 
 //*****************************************************************************
 //
 // This is the code that gets called when the processor receives a fault
-// interrupt.  This simply enters an infinite loop, preserving the system state
-// for examination by a debugger.
+// interrupt.  The crash is recorded and the processor reset (see crash.h).
 //
 //*****************************************************************************
+__attribute__ ((naked))
 static void
 FaultISR(void)
 {
-    //
-    // Enter an infinite loop.
-    //
-    while(1)
-    {
-    }
+    CRASH_CAPTURE;
 }
 
 //*****************************************************************************
@@ -0,0 +1,64 @@
+/******************************************************************************
+ * NAME:	    tap.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Record format of the tap output. Every run of chars read
+ *                  from a UART is sent as
+ *
+ *                    SYNC tag stamp[4] data...
+ *
+ *                  where the low 7 bits of `tag' are the length of `data'
+ *                  (1..TAP_MAX_RUN), bit 7 is set for chars from the target,
+ *                  and `stamp' (little-endian) is the low 32 bits of the
+ *                  timebase when the run was read, in system clock cycles.
+ *                  A record with a tag of 0 has no data, and its `stamp' is
+ *                  the upper 32 bits of the timebase for the records that
+ *                  follow. See tools/tapdecode.c for the host end.
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+#ifndef TAP_H
+#define TAP_H
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stdint.h>
+
+// Format constants, shared with the host tool.
+#define TAP_SYNC            0xa5
+#define TAP_FROM_TARGET     0x80
+#define TAP_MAX_RUN         127
+#define TAP_EPOCH           0x00
+#define TAP_HEADER_SIZE     6
+
+/******************************************************************************
+ * FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        TapHeader
+ *
+ * DESCRIPTION:     Write the header of a record.
+ *
+ * RETURNS:         TAP_HEADER_SIZE.
+ ***/
+static inline uint32_t TapHeader(uint8_t* out, uint8_t tag, uint32_t stamp)
+{
+  out[0] = TAP_SYNC;
+  out[1] = tag;
+  for (uint32_t i = 0; i < 4; ++i) {
+    out[2 + i] = (uint8_t)(stamp >> (8 * i));
+  }
+
+  return TAP_HEADER_SIZE;
+}
+
+#endif // TAP_H
+
+/*****************************************************************************/
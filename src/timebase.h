@@ -0,0 +1,76 @@
+/******************************************************************************
+ * NAME:	    timebase.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Free-running timestamp source, built on Wide Timer 0 in
+ *                  concatenated 64-bit up-count mode at the system clock.
+ *                  The low 32 bits are enough for measuring short intervals
+ *                  (they wrap every ~53 seconds at 80 MHz); the full 64 bits
+ *                  never wrap in practice.
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_timer.h"
+#include "inc/hw_types.h"
+#include "driverlib/rom.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+
+#define TIMEBASE_BASE WTIMER0_BASE
+
+/******************************************************************************
+ * FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        TimebaseInit
+ *
+ * DESCRIPTION:     Start the timebase. Must be called after the system clock
+ *                  is configured, since it counts system clock cycles.
+ ***/
+static inline void TimebaseInit(void)
+{
+  ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_WTIMER0);
+  TimerConfigure(TIMEBASE_BASE, TIMER_CFG_PERIODIC_UP);
+  TimerLoadSet64(TIMEBASE_BASE, UINT64_MAX);
+  TimerEnable(TIMEBASE_BASE, TIMER_BOTH);
+}
+
+/******************************************************************************
+ * FUNCTION:        TimebaseNow
+ *
+ * DESCRIPTION:     Low 32 bits of the timebase. Subtract two readings (as
+ *                  uint32_t) to get the elapsed system clock cycles.
+ ***/
+static inline uint32_t TimebaseNow(void)
+{
+  return HWREG(TIMEBASE_BASE + TIMER_O_TAR);
+}
+
+/******************************************************************************
+ * FUNCTION:        TimebaseNow64
+ *
+ * DESCRIPTION:     The full 64-bit timebase.
+ ***/
+static inline uint64_t TimebaseNow64(void)
+{
+  return TimerValueGet64(TIMEBASE_BASE);
+}
+
+#endif // TIMEBASE_H
+
+/*****************************************************************************/
@@ -0,0 +1,189 @@
+/******************************************************************************
+ * NAME:	    trace.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Event trace over the ITM and SWO. Each kind of event is
+ *                  written to its own stimulus port, so the port number in
+ *                  the ITM packet says what happened and the payload says
+ *                  where:
+ *
+ *                    port  payload                  event
+ *                    1     source (8 bits)          interrupt entry
+ *                    2     source (8 bits)          interrupt exit
+ *                    3     source << 24 | count     chars read from RX FIFO
+ *                    4     source << 24 | count     chars written to TX FIFO
+ *                    5     source << 24 | count     chars forwarded from the
+ *                                                   source's rx queue
+ *                    6     source (8 bits)          TX FIFO full, chars still
+ *                                                   queued
+ *                    7     source (8 bits)          rx queue full, char
+ *                                                   dropped
+ *                    8     source (8 bits)          RX FIFO overrun
+ *                    9     mode (8 bits)            mode change
+ *
+ *                  The ITM's local timestamps count CPU cycles, so the host
+ *                  end (tools/swodecode.c) can put every event on a common
+ *                  timeline. Without CONFIG_UART_TRACE the macros compile to
+ *                  nothing. An event that finds its stimulus port busy is
+ *                  dropped (and counted) rather than stalling an interrupt.
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stdint.h>
+
+// Stimulus ports, shared with the host tool.
+#define TRACE_PORT_ENTER        1
+#define TRACE_PORT_EXIT         2
+#define TRACE_PORT_RX           3
+#define TRACE_PORT_TX           4
+#define TRACE_PORT_FORWARD      5
+#define TRACE_PORT_FIFO_FULL    6
+#define TRACE_PORT_DROP         7
+#define TRACE_PORT_OVERRUN      8
+#define TRACE_PORT_MODE         9
+
+// Sources.
+#define TRACE_UART0             0
+#define TRACE_UART1             1
+#define TRACE_TAP               2
+#define TRACE_BOTTOM_HALF       3
+
+// Modes.
+#define TRACE_MODE_INTERRUPT    0
+#define TRACE_MODE_POLL         1
+#define TRACE_MODE_BERT         2
+#define TRACE_MODE_BENCH        3
+
+#ifdef CONFIG_UART_TRACE
+
+#include "inc/hw_nvic.h"
+#include "inc/hw_types.h"
+#include "cycles.h"
+
+// SWO bit rate. The TPIU divides the system clock down to it, so it should
+// divide the clock evenly. A USB serial adapter on PC3 can capture it.
+#ifndef CONFIG_UART_TRACE_SWO_BAUDRATE
+#define CONFIG_UART_TRACE_SWO_BAUDRATE 8000000
+#endif
+
+// TivaWare doesn't define the ITM or TPIU registers.
+#define ITM_STIM(port)          (0xE0000000 + 4 * (port))
+#define ITM_TER                 0xE0000E00  // Trace Enable
+#define ITM_TCR                 0xE0000E80  // Trace Control
+#define ITM_LAR                 0xE0000FB0  // Lock Access
+#define ITM_LAR_UNLOCK          0xC5ACCE55
+#define ITM_TCR_ITMENA          0x00000001  // ITM Enable
+#define ITM_TCR_TSENA           0x00000002  // Local Timestamp Enable
+#define ITM_TCR_SYNCENA         0x00000004  // Sync Packet Enable
+#define ITM_TCR_TRACEBUSID_1    0x00010000  // ATB ID 1
+#define TPIU_ACPR               0xE0040010  // Async Clock Prescaler
+#define TPIU_SPPR               0xE00400F0  // Selected Pin Protocol
+#define TPIU_FFCR               0xE0040304  // Formatter and Flush Control
+#define TPIU_SPPR_NRZ           0x00000002
+#define TPIU_FFCR_TRIGIN        0x00000100  // Formatter off
+#define DWT_CTRL_SYNCTAP_24     0x00000400  // Sync packet every 2^24 cycles
+
+// Events lost because their stimulus port was busy.
+extern volatile uint32_t g_traceDropped;
+
+#define TRACE_ENTER(source) TraceWrite8(TRACE_PORT_ENTER, (source))
+#define TRACE_EXIT(source) TraceWrite8(TRACE_PORT_EXIT, (source))
+#define TRACE_RX(source, count) TraceCount(TRACE_PORT_RX, (source), (count))
+#define TRACE_TX(source, count) TraceCount(TRACE_PORT_TX, (source), (count))
+#define TRACE_FORWARD(source, count) \
+  TraceCount(TRACE_PORT_FORWARD, (source), (count))
+#define TRACE_FIFO_FULL(source) TraceWrite8(TRACE_PORT_FIFO_FULL, (source))
+#define TRACE_DROP(source) TraceWrite8(TRACE_PORT_DROP, (source))
+#define TRACE_OVERRUN(source) TraceWrite8(TRACE_PORT_OVERRUN, (source))
+#define TRACE_MODE(mode) TraceWrite8(TRACE_PORT_MODE, (mode))
+
+/******************************************************************************
+ * FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        TraceInit
+ *
+ * DESCRIPTION:     Route the ITM out of the SWO pin as NRZ at
+ *                  CONFIG_UART_TRACE_SWO_BAUDRATE, with local timestamps in
+ *                  CPU cycles and periodic sync packets (which need the cycle
+ *                  counter running). A debugger that configures SWO itself
+ *                  may override this.
+ *
+ * ARGUMENTS:       clockHz: The system clock.
+ ***/
+static inline void TraceInit(uint32_t clockHz)
+{
+  HWREG(NVIC_DBG_INT) |= NVIC_DBG_INT_TRCENA;
+  HWREG(TPIU_SPPR) = TPIU_SPPR_NRZ;
+  HWREG(TPIU_ACPR) = clockHz / CONFIG_UART_TRACE_SWO_BAUDRATE - 1;
+  HWREG(TPIU_FFCR) = TPIU_FFCR_TRIGIN;
+  HWREG(DWT_CTRL) |= DWT_CTRL_SYNCTAP_24;
+
+  HWREG(ITM_LAR) = ITM_LAR_UNLOCK;
+  HWREG(ITM_TCR) = ITM_TCR_TRACEBUSID_1 | ITM_TCR_SYNCENA | ITM_TCR_TSENA
+    | ITM_TCR_ITMENA;
+  HWREG(ITM_TER) = (1u << (TRACE_PORT_MODE + 1)) - (1u << TRACE_PORT_ENTER);
+}
+
+/******************************************************************************
+ * FUNCTION:        TraceWrite8
+ *
+ * DESCRIPTION:     Write an 8-bit event, if the stimulus port can take it.
+ ***/
+static inline void TraceWrite8(uint32_t port, uint8_t value)
+{
+  if (HWREG(ITM_STIM(port))) {
+    HWREGB(ITM_STIM(port)) = value;
+  } else {
+    g_traceDropped++;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:        TraceCount
+ *
+ * DESCRIPTION:     Write a 32-bit count event. Counts of zero aren't sent.
+ ***/
+static inline void TraceCount(uint32_t port, uint8_t source, uint32_t count)
+{
+  if (0 == count) {
+    return;
+  } else if (HWREG(ITM_STIM(port))) {
+    HWREG(ITM_STIM(port)) = ((uint32_t)source << 24) | (count & 0xffffff);
+  } else {
+    g_traceDropped++;
+  }
+}
+
+#else
+
+// The counts are evaluated, so that a variable kept only for them isn't
+// reported as unused. The sources aren't, since uart_t only has its trace
+// source in a trace build.
+#define TRACE_ENTER(source) ((void)0)
+#define TRACE_EXIT(source) ((void)0)
+#define TRACE_RX(source, count) ((void)(count))
+#define TRACE_TX(source, count) ((void)(count))
+#define TRACE_FORWARD(source, count) ((void)(count))
+#define TRACE_FIFO_FULL(source) ((void)0)
+#define TRACE_DROP(source) ((void)0)
+#define TRACE_OVERRUN(source) ((void)0)
+#define TRACE_MODE(mode) ((void)0)
+
+#endif // CONFIG_UART_TRACE
+
+#endif // TRACE_H
+
+/*****************************************************************************/
@@ -0,0 +1,492 @@
+/******************************************************************************
+ * NAME:	    arqhost.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Host end of the reliable link of a SerialBridge built with
+ *                  CONFIG_UART_ARQ=1, running the same ARQ and framing code
+ *                  as the firmware (src/arq.c, src/frame.c).
+ *
+ *                    arqhost [-q] [-t ms] [-b ber] tty
+ *                        Send stdin to the target through the bridge, and
+ *                        write what the target sends to stdout. With -q,
+ *                        exit once stdin is at EOF and all of it has been
+ *                        acknowledged. -t sets the retransmission timeout
+ *                        (default 100 ms).
+ *
+ *                    arqhost -s [-1] [-n bytes] [-l chars] [-b ber]
+ *                        Self test: run two ends against each other over a
+ *                        simulated full-duplex line, with `chars' character
+ *                        times of latency each way (default 300), and report
+ *                        goodput as a fraction of the line rate. With -1,
+ *                        only the bridge end sends data.
+ *
+ *                  -b injects random bit errors into every byte sent and
+ *                  received, at the given bit error rate.
+ *
+ *                  The window is fixed at build time, and must match the
+ *                  firmware's: build both with the same
+ *                  CONFIG_UART_ARQ_WINDOW.
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "arq.h"
+#include "frame.h"
+
+// Depth of each end's transmit queue in the self test, as in the firmware.
+#define SIM_QUEUE_SIZE 1024
+
+// Bit errors are placed a geometrically distributed number of bits apart.
+typedef struct {
+
+  double ber;
+  uint64_t untilError;
+
+} injector_t;
+
+// One end of the simulated line.
+typedef struct {
+
+  arq_t arq;
+  framelink_t link;
+  uint8_t queue[SIM_QUEUE_SIZE];
+  uint32_t queueHead;
+  uint32_t queueTail;
+  // Data still to send, and the streams used to generate and check it.
+  uint32_t toSend;
+  uint32_t sendState;
+  uint32_t checkState;
+  uint32_t errors;
+
+} endpoint_t;
+
+// One direction of the simulated line: a delay line of `latency' chars.
+typedef struct {
+
+  int16_t* slots;
+  uint32_t latency;
+  uint32_t position;
+
+} wire_t;
+
+/******************************************************************************
+ * FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        NextErrorGap
+ *
+ * DESCRIPTION:     Draw the number of good bits before the next error.
+ ***/
+static uint64_t NextErrorGap(double ber)
+{
+  if (ber <= 0) {
+    return UINT64_MAX;
+  }
+
+  double u = (rand() + 1.0) / ((double)RAND_MAX + 2.0);
+  return (uint64_t)(log(u) / log1p(-ber));
+}
+
+/******************************************************************************
+ * FUNCTION:        Inject
+ *
+ * DESCRIPTION:     Flip bits of `data' at the injector's bit error rate.
+ ***/
+static void Inject(injector_t* injector, uint8_t* data, size_t length)
+{
+  if (injector->ber <= 0) {
+    return;
+  }
+
+  for (size_t i = 0; i < length; ++i) {
+    for (int bit = 0; bit < 8; ++bit) {
+      if (0 == injector->untilError) {
+        data[i] ^= (uint8_t)(1 << bit);
+        injector->untilError = NextErrorGap(injector->ber);
+      } else {
+        injector->untilError--;
+      }
+    }
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:        NowUs
+ *
+ * DESCRIPTION:     Monotonic time in microseconds, as the ARQ's clock.
+ ***/
+static uint32_t NowUs(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)((uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000);
+}
+
+/******************************************************************************
+ * FUNCTION:        WriteAll
+ *
+ * DESCRIPTION:     Write all of `data' to `fd'.
+ *
+ * RETURNS:         false on error.
+ ***/
+static bool WriteAll(int fd, const uint8_t* data, size_t length)
+{
+  while (0 < length) {
+    ssize_t written = write(fd, data, length);
+    if (written < 0 && EINTR != errno) {
+      return false;
+    } else if (0 < written) {
+      data += written;
+      length -= (size_t)written;
+    }
+  }
+
+  return true;
+}
+
+/******************************************************************************
+ * FUNCTION:        SendPacket
+ *
+ * DESCRIPTION:     Frame an ARQ packet and write it to the tty.
+ ***/
+static bool SendPacket(int fd, framelink_t* link, injector_t* injector,
+  const uint8_t* packet, uint32_t length)
+{
+  uint8_t frame[FRAME_BOUND(FRAME_MAX_PAYLOAD)];
+  uint32_t count = FrameEncode(link, packet, length, frame);
+  Inject(injector, frame, count);
+  return WriteAll(fd, frame, count);
+}
+
+/******************************************************************************
+ * FUNCTION:        RunLink
+ *
+ * DESCRIPTION:     Run the host end of the link on `tty' until stdin is done
+ *                  (with `quit'), or the tty goes away.
+ *
+ * RETURNS:         Exit status.
+ ***/
+static int RunLink(const char* tty, uint32_t timeoutUs, bool quit,
+  injector_t* injector)
+{
+  int fd = open(tty, O_RDWR | O_NOCTTY);
+  if (fd < 0) {
+    perror(tty);
+    return 1;
+  }
+
+  static arq_t arq;
+  static framelink_t link;
+  uint8_t packet[FRAME_MAX_PAYLOAD];
+  uint8_t buffer[4096];
+  bool inputDone = false;
+
+  ArqInit(&arq, timeoutUs);
+  FrameInit(&link);
+
+  while (!(quit && inputDone && !ArqBusy(&arq))) {
+    uint32_t length = 0;
+    while (0 < (length = ArqPoll(&arq, NowUs(), packet))) {
+      if (!SendPacket(fd, &link, injector, packet, length)) {
+        perror(tty);
+        return 1;
+      }
+    }
+
+    // Wake up at least once a millisecond to check the timeouts.
+    struct pollfd fds[2] = {
+      { .fd = fd, .events = POLLIN },
+      { .fd = STDIN_FILENO, .events = POLLIN },
+    };
+    const nfds_t count = !inputDone && ArqCanSend(&arq) ? 2 : 1;
+    if (poll(fds, count, 1) < 0 && EINTR != errno) {
+      perror("poll");
+      return 1;
+    }
+
+    if (fds[0].revents & (POLLERR | POLLHUP)) {
+      fprintf(stderr, "%s: hung up\n", tty);
+      return 1;
+    } else if (fds[0].revents & POLLIN) {
+      ssize_t received = read(fd, buffer, sizeof(buffer));
+      if (received < 0) {
+        perror(tty);
+        return 1;
+      }
+
+      Inject(injector, buffer, (size_t)received);
+      for (ssize_t i = 0; i < received; ++i) {
+        uint32_t payload = FrameReceive(&link, buffer[i]);
+        if (0 < payload) {
+          ArqReceive(&arq, link.buffer, payload);
+        }
+      }
+
+      const uint8_t* data = NULL;
+      while (0 < (length = ArqPeek(&arq, &data))) {
+        if (!WriteAll(STDOUT_FILENO, data, length)) {
+          perror("stdout");
+          return 1;
+        }
+        ArqRelease(&arq);
+      }
+    }
+
+    if (2 == count && (fds[1].revents & (POLLIN | POLLHUP))) {
+      ssize_t input = read(STDIN_FILENO, buffer, ARQ_MAX_PAYLOAD);
+      if (input <= 0) {
+        inputDone = true;
+      } else if (!SendPacket(fd, &link, injector, packet,
+          ArqSend(&arq, buffer, (uint32_t)input, NowUs(), packet))) {
+        perror(tty);
+        return 1;
+      }
+    }
+  }
+
+  close(fd);
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:        Stream
+ *
+ * DESCRIPTION:     Next byte of a test stream (xorshift32).
+ ***/
+static uint8_t Stream(uint32_t* state)
+{
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return (uint8_t)x;
+}
+
+/******************************************************************************
+ * FUNCTION:        SimProduce
+ *
+ * DESCRIPTION:     Queue frames from one end of the self test, the way the
+ *                  firmware's bottom half does: replies first, then full
+ *                  packets of new data, while a whole frame fits.
+ ***/
+static void SimProduce(endpoint_t* end, uint32_t now)
+{
+  uint8_t packet[FRAME_MAX_PAYLOAD];
+  uint8_t data[ARQ_MAX_PAYLOAD];
+  uint8_t frame[FRAME_BOUND(FRAME_MAX_PAYLOAD)];
+
+  while (SIM_QUEUE_SIZE - (end->queueHead - end->queueTail) >= sizeof(frame)) {
+    uint32_t length = ArqPoll(&end->arq, now, packet);
+    if (0 == length && 0 < end->toSend && ArqCanSend(&end->arq)) {
+      uint32_t size = end->toSend < ARQ_MAX_PAYLOAD
+        ? end->toSend : ARQ_MAX_PAYLOAD;
+      for (uint32_t i = 0; i < size; ++i) {
+        data[i] = Stream(&end->sendState);
+      }
+      end->toSend -= size;
+      length = ArqSend(&end->arq, data, size, now, packet);
+    }
+    if (0 == length) {
+      break;
+    }
+
+    uint32_t count = FrameEncode(&end->link, packet, length, frame);
+    for (uint32_t i = 0; i < count; ++i) {
+      end->queue[end->queueHead++ % SIM_QUEUE_SIZE] = frame[i];
+    }
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:        SimConsume
+ *
+ * DESCRIPTION:     Feed one byte off the line to an end of the self test, and
+ *                  check whatever it delivers.
+ ***/
+static void SimConsume(endpoint_t* end, uint8_t c)
+{
+  uint32_t payload = FrameReceive(&end->link, c);
+  if (0 == payload) {
+    return;
+  }
+
+  ArqReceive(&end->arq, end->link.buffer, payload);
+  const uint8_t* data = NULL;
+  uint32_t length = 0;
+  while (0 < (length = ArqPeek(&end->arq, &data))) {
+    for (uint32_t i = 0; i < length; ++i) {
+      if (data[i] != Stream(&end->checkState)) {
+        end->errors++;
+      }
+    }
+    ArqRelease(&end->arq);
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:        SimTransmit
+ *
+ * DESCRIPTION:     Move one char time of traffic from `from' onto `wire', and
+ *                  whatever comes off the other end of it into `to'.
+ ***/
+static void SimTransmit(endpoint_t* from, wire_t* wire, endpoint_t* to,
+  injector_t* injector)
+{
+  int16_t sent = -1;
+  if (from->queueHead != from->queueTail) {
+    uint8_t c = from->queue[from->queueTail++ % SIM_QUEUE_SIZE];
+    Inject(injector, &c, 1);
+    sent = c;
+  }
+
+  int16_t arrived = wire->slots[wire->position];
+  wire->slots[wire->position] = sent;
+  wire->position = (wire->position + 1) % wire->latency;
+  if (0 <= arrived) {
+    SimConsume(to, (uint8_t)arrived);
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:        PrintStats
+ *
+ * DESCRIPTION:     Report one direction of the self test.
+ ***/
+static void PrintStats(const char* name, const endpoint_t* from,
+  const endpoint_t* to, uint64_t ticks)
+{
+  printf("%s: %u bytes in %llu char times, goodput %.1f%% of line rate\n",
+    name, to->arq.payloadDelivered, (unsigned long long)ticks,
+    100.0 * to->arq.payloadDelivered / ticks);
+  printf("  packets %u, retransmits %u (timeouts %u), naks %u, "
+    "crc errors %u, data errors %u\n", from->arq.dataSent,
+    from->arq.retransmits, from->arq.timeouts, to->arq.naksSent,
+    to->link.crcErrors, to->errors);
+}
+
+/******************************************************************************
+ * FUNCTION:        SelfTest
+ *
+ * DESCRIPTION:     Run the self test. The clock is in char times.
+ *
+ * RETURNS:         Exit status: 0 if all data arrived intact.
+ ***/
+static int SelfTest(uint32_t bytes, uint32_t latency, bool oneWay,
+  injector_t* injector)
+{
+  static endpoint_t host;
+  static endpoint_t bridge;
+  wire_t up = { calloc(latency, sizeof(int16_t)), latency, 0 };
+  wire_t down = { calloc(latency, sizeof(int16_t)), latency, 0 };
+  for (uint32_t i = 0; i < latency; ++i) {
+    up.slots[i] = down.slots[i] = -1;
+  }
+
+  // The same timeout the firmware uses, with the latency as the other end's
+  // turnaround.
+  const uint32_t timeout = SIM_QUEUE_SIZE
+    + ARQ_WINDOW * (FRAME_MAX_PAYLOAD + 2 * FRAME_CRC_SIZE) + 2 * latency;
+  endpoint_t* ends[] = { &host, &bridge };
+  for (int i = 0; i < 2; ++i) {
+    ArqInit(&ends[i]->arq, timeout);
+    FrameInit(&ends[i]->link);
+  }
+  host.sendState = bridge.checkState = 0x12345678;
+  bridge.sendState = host.checkState = 0x9abcdef0;
+  bridge.toSend = bytes;
+  host.toSend = oneWay ? 0 : bytes;
+
+  const uint64_t limit = 100 * (uint64_t)bytes + 1000000;
+  uint64_t ticks = 0;
+  while (ticks < limit && (host.arq.payloadDelivered < bytes
+      || (!oneWay && bridge.arq.payloadDelivered < bytes))) {
+    SimProduce(&host, (uint32_t)ticks);
+    SimProduce(&bridge, (uint32_t)ticks);
+    SimTransmit(&bridge, &up, &host, injector);
+    SimTransmit(&host, &down, &bridge, injector);
+    ticks++;
+  }
+
+  printf("window %d, latency %u chars, ber %g\n", ARQ_WINDOW, latency,
+    injector->ber);
+  PrintStats("bridge->host", &bridge, &host, ticks);
+  if (!oneWay) {
+    PrintStats("host->bridge", &host, &bridge, ticks);
+  }
+
+  free(up.slots);
+  free(down.slots);
+  if (ticks == limit || 0 < host.errors || 0 < bridge.errors) {
+    fprintf(stderr, "self test failed\n");
+    return 1;
+  }
+  return 0;
+}
+
+/******************************************************************************
+ * MAIN
+ ***/
+
+int main(int argc, char** argv)
+{
+  injector_t injector = { 0 };
+  uint32_t timeoutMs = 100;
+  uint32_t bytes = 1 << 20;
+  uint32_t latency = 300;
+  bool selfTest = false;
+  bool oneWay = false;
+  bool quit = false;
+  int opt = 0;
+
+  while (-1 != (opt = getopt(argc, argv, "sq1b:t:n:l:"))) {
+    switch (opt) {
+    case 's': selfTest = true; break;
+    case 'q': quit = true; break;
+    case '1': oneWay = true; break;
+    case 'b': injector.ber = atof(optarg); break;
+    case 't': timeoutMs = (uint32_t)atoi(optarg); break;
+    case 'n': bytes = (uint32_t)atoi(optarg); break;
+    case 'l': latency = (uint32_t)atoi(optarg); break;
+    default:
+      fprintf(stderr, "usage: %s [-q] [-t ms] [-b ber] tty\n"
+        "       %s -s [-1] [-n bytes] [-l chars] [-b ber]\n", argv[0],
+        argv[0]);
+      return 1;
+    }
+  }
+
+  srand(1);
+  injector.untilError = NextErrorGap(injector.ber);
+  if (selfTest) {
+    return SelfTest(bytes, latency ? latency : 1, oneWay, &injector);
+  }
+
+  if (optind + 1 != argc) {
+    fprintf(stderr, "%s: expected a tty\n", argv[0]);
+    return 1;
+  }
+  return RunLink(argv[optind], timeoutMs * 1000, quit, &injector);
+}
+
+/*****************************************************************************/
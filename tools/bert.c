@@ -0,0 +1,281 @@
+/******************************************************************************
+ * NAME:	    bert.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Host end of the bit-error-rate tester of a SerialBridge
+ *                  built with CONFIG_UART_BERT=1, running the same generator
+ *                  and checker as the firmware (src/prbs.c).
+ *
+ *                    bert [-p pattern] [-t | -r] [-i seconds] tty
+ *                        Send the PRBS to the tty as fast as it will take
+ *                        it, and check what comes back, printing the counts
+ *                        every `seconds' (default 1). With -t, only send;
+ *                        with -r, only check. The pattern is 7, 15 or 31
+ *                        (default 31), and must match the other end's.
+ *
+ *                    bert -s [-p pattern] [-n chars] [-b ber] [-d rate]
+ *                        [-g rate]
+ *                        Self test: feed the checker a stream with bit
+ *                        errors at `ber', and chars dropped or garbage chars
+ *                        added at the given rates (per char), and compare
+ *                        what it counted with what was done to the stream.
+ *
+ *                  Set the baud rate with stty first, e.g.
+ *
+ *                    stty -F /dev/ttyUSB0 raw 921600
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "prbs.h"
+
+/******************************************************************************
+ * FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        Uniform
+ *
+ * DESCRIPTION:     A random number in (0, 1).
+ ***/
+static double Uniform(void)
+{
+  return (rand() + 1.0) / ((double)RAND_MAX + 2.0);
+}
+
+/******************************************************************************
+ * FUNCTION:        NextErrorGap
+ *
+ * DESCRIPTION:     Draw the number of good bits before the next error.
+ ***/
+static uint64_t NextErrorGap(double ber)
+{
+  if (ber <= 0) {
+    return UINT64_MAX;
+  }
+
+  return (uint64_t)(log(Uniform()) / log1p(-ber));
+}
+
+/******************************************************************************
+ * FUNCTION:        PrintCounts
+ *
+ * DESCRIPTION:     Print the checker's statistics on one line.
+ ***/
+static void PrintCounts(const prbs_checker_t* checker)
+{
+  const double ber = 0 < checker->bitsChecked
+    ? (double)checker->bitErrors / (double)checker->bitsChecked : 0;
+  fprintf(stderr, "%s chars %llu bits %llu errors %llu (BER %.3g) locks %u"
+    " resyncs %u slips %u (-%u +%u)\n", checker->locked ? "locked" : "hunting",
+    (unsigned long long)checker->chars,
+    (unsigned long long)checker->bitsChecked,
+    (unsigned long long)checker->bitErrors, ber, checker->locks,
+    checker->resyncs, checker->slips, checker->charsLost,
+    checker->charsGained);
+}
+
+/******************************************************************************
+ * FUNCTION:        SelfTest
+ *
+ * DESCRIPTION:     Damage a generated stream and check it.
+ *
+ * RETURNS:         Exit status.
+ ***/
+static int SelfTest(uint32_t pattern, uint64_t chars, double ber,
+  double dropRate, double addRate)
+{
+  prbs_t generator;
+  static prbs_checker_t checker;
+  PrbsInit(&generator, pattern);
+  PrbsCheckerInit(&checker, pattern);
+
+  uint64_t untilError = NextErrorGap(ber);
+  uint64_t flipped = 0;
+  uint32_t dropped = 0;
+  uint32_t added = 0;
+
+  for (uint64_t i = 0; i < chars; ++i) {
+    uint8_t c = PrbsNext(&generator);
+    if (Uniform() < dropRate) {
+      dropped++;
+      continue;
+    }
+
+    if (Uniform() < addRate) {
+      added++;
+      PrbsCheck(&checker, (uint8_t)rand());
+    }
+
+    for (int bit = 0; bit < 8; ++bit) {
+      if (0 == untilError) {
+        c ^= (uint8_t)(1 << bit);
+        flipped++;
+        untilError = NextErrorGap(ber);
+      } else {
+        untilError--;
+      }
+    }
+    PrbsCheck(&checker, c);
+  }
+
+  fprintf(stderr, "PRBS%u: flipped %llu bits, dropped %u chars, added %u\n",
+    pattern, (unsigned long long)flipped, dropped, added);
+  PrintCounts(&checker);
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:        RunTty
+ *
+ * DESCRIPTION:     Send and/or check the PRBS on `tty' until interrupted.
+ *
+ * RETURNS:         Exit status.
+ ***/
+static int RunTty(const char* tty, uint32_t pattern, bool send, bool check,
+  uint32_t interval)
+{
+  int fd = open(tty, O_RDWR | O_NOCTTY);
+  if (fd < 0) {
+    perror(tty);
+    return 1;
+  }
+
+  prbs_t generator;
+  static prbs_checker_t checker;
+  PrbsInit(&generator, pattern);
+  PrbsCheckerInit(&checker, pattern);
+
+  uint8_t out[256];
+  uint32_t outHead = 0;
+  uint32_t outTail = 0;
+  uint8_t in[4096];
+  time_t lastReport = time(NULL);
+
+  while (1) {
+    if (send && outHead == outTail) {
+      for (outHead = 0; outHead < sizeof(out); ++outHead) {
+        out[outHead] = PrbsNext(&generator);
+      }
+      outTail = 0;
+    }
+
+    struct pollfd fds = {
+      .fd = fd,
+      .events = (check ? POLLIN : 0) | (send ? POLLOUT : 0),
+    };
+    if (poll(&fds, 1, 100) < 0 && EINTR != errno) {
+      perror("poll");
+      return 1;
+    }
+
+    if (fds.revents & (POLLERR | POLLHUP)) {
+      fprintf(stderr, "%s: hung up\n", tty);
+      return 1;
+    }
+
+    if (fds.revents & POLLIN) {
+      ssize_t received = read(fd, in, sizeof(in));
+      if (received < 0 && EINTR != errno) {
+        perror(tty);
+        return 1;
+      }
+      for (ssize_t i = 0; i < received; ++i) {
+        PrbsCheck(&checker, in[i]);
+      }
+    }
+
+    if (fds.revents & POLLOUT) {
+      ssize_t written = write(fd, out + outTail, outHead - outTail);
+      if (written < 0 && EINTR != errno) {
+        perror(tty);
+        return 1;
+      } else if (0 < written) {
+        outTail += (uint32_t)written;
+      }
+    }
+
+    const time_t now = time(NULL);
+    if (check && now - lastReport >= (time_t)interval) {
+      PrintCounts(&checker);
+      lastReport = now;
+    }
+  }
+}
+
+/******************************************************************************
+ * MAIN
+ ***/
+
+int main(int argc, char** argv)
+{
+  uint32_t pattern = 31;
+  uint32_t interval = 1;
+  uint64_t chars = 10000000;
+  double ber = 0;
+  double dropRate = 0;
+  double addRate = 0;
+  bool selfTest = false;
+  bool send = true;
+  bool check = true;
+  int opt = 0;
+
+  while (-1 != (opt = getopt(argc, argv, "strp:i:n:b:d:g:"))) {
+    switch (opt) {
+    case 's': selfTest = true; break;
+    case 't': check = false; break;
+    case 'r': send = false; break;
+    case 'p': pattern = (uint32_t)atoi(optarg); break;
+    case 'i': interval = (uint32_t)atoi(optarg); break;
+    case 'n': chars = strtoull(optarg, NULL, 0); break;
+    case 'b': ber = atof(optarg); break;
+    case 'd': dropRate = atof(optarg); break;
+    case 'g': addRate = atof(optarg); break;
+    default:
+      fprintf(stderr, "usage: %s [-p pattern] [-t | -r] [-i seconds] tty\n"
+        "       %s -s [-p pattern] [-n chars] [-b ber] [-d rate] [-g rate]\n",
+        argv[0], argv[0]);
+      return 1;
+    }
+  }
+
+  prbs_t probe;
+  if (!PrbsInit(&probe, pattern)) {
+    fprintf(stderr, "%s: pattern must be 7, 15 or 31\n", argv[0]);
+    return 1;
+  }
+
+  srand(1);
+  if (selfTest) {
+    return SelfTest(pattern, chars, ber, dropRate, addRate);
+  }
+
+  if (!(send || check)) {
+    fprintf(stderr, "%s: -t and -r leave nothing to do\n", argv[0]);
+    return 1;
+  } else if (optind + 1 != argc) {
+    fprintf(stderr, "%s: expected a tty\n", argv[0]);
+    return 1;
+  }
+  return RunTty(argv[optind], pattern, send, check, interval);
+}
+
+/*****************************************************************************/
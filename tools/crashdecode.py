@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+###############################################################################
+# NAME:		    crashdecode.py
+#
+# AUTHOR:	    Ethan D. Twardy
+#
+# DESCRIPTION:	    Decodes the crash record a SerialBridge sends when SW1 is
+#                   held down at reset (see src/crash.h). Reads what the host
+#                   received on the upstream port, finds the last record in
+#                   it, and prints the registers, the faults the status
+#                   registers name and the last chars sent on each UART:
+#
+#                     tools/crashdecode.py capture.txt
+#                     tools/crashdecode.py -e SerialBridge.axf capture.txt
+#
+#                   With -e, the pc and lr are looked up in the image with
+#                   addr2line, which must be the build's own
+#                   (arm-none-eabi-addr2line, or --addr2line).
+#
+#                   On a framed link, unwrap the capture first:
+#
+#                     tools/deframe < capture.bin | tools/crashdecode.py
+#
+# CREATED:	    10/19/2026
+#
+# LAST EDITED:	    10/19/2026
+###
+
+import argparse
+import re
+import subprocess
+import sys
+
+REGISTERS = [
+    'r0', 'r1', 'r2', 'r3', 'r12', 'lr', 'pc', 'xpsr',
+    'r4', 'r5', 'r6', 'r7', 'r8', 'r9', 'r10', 'r11',
+    'sp', 'exc_return', 'cfsr', 'hfsr', 'mmfar', 'bfar',
+]
+
+EXCEPTIONS = {2: 'NMI', 3: 'hard fault'}
+
+# Bits of the configurable fault status register (MMFSR, BFSR and UFSR).
+CFSR_BITS = [
+    (0, 'IACCVIOL: instruction fetch from a protected region'),
+    (1, 'DACCVIOL: data access to a protected region'),
+    (3, 'MUNSTKERR: MPU fault on exception return'),
+    (4, 'MSTKERR: MPU fault on exception entry'),
+    (5, 'MLSPERR: MPU fault stacking the FPU state'),
+    (8, 'IBUSERR: bus fault on instruction fetch'),
+    (9, 'PRECISERR: bus fault on data access, at bfar'),
+    (10, 'IMPRECISERR: bus fault on a buffered write; pc is past it'),
+    (11, 'UNSTKERR: bus fault on exception return'),
+    (12, 'STKERR: bus fault on exception entry (stack overflow?)'),
+    (13, 'LSPERR: bus fault stacking the FPU state'),
+    (16, 'UNDEFINSTR: undefined instruction'),
+    (17, 'INVSTATE: Thumb bit clear (call through a bad pointer?)'),
+    (18, 'INVPC: bad exception return'),
+    (19, 'NOCP: coprocessor (FPU) access while it\'s off'),
+    (24, 'UNALIGNED: unaligned access'),
+    (25, 'DIVBYZERO: divide by zero'),
+]
+MMARVALID = 1 << 7
+BFARVALID = 1 << 15
+
+HFSR_BITS = [
+    (1, 'VECTTBL: bus fault reading the vector table'),
+    (30, 'FORCED: escalated from a fault that couldn\'t be taken'),
+    (31, 'DEBUGEVT: debug event'),
+]
+
+HEADER = re.compile(
+    r'crash: exception ([0-9a-f]{2}) count ([0-9a-f]{8})'
+    r' cycles ([0-9a-f]{8})')
+REGISTER = re.compile(r'\b([a-z0-9_]+) ([0-9a-f]{8})\b')
+RECENT = re.compile(r'^uart([01])((?: [0-9a-f]{2})*)\s*$')
+
+
+def ParseRecord(text):
+    """The last record in `text', as (exception, count, cycles, registers,
+    recent), or None if there isn't one."""
+    start = None
+    for start in HEADER.finditer(text):
+        pass
+    if start is None:
+        return None
+
+    exception, count, cycles = (int(group, 16) for group in start.groups())
+    registers = {}
+    recent = {}
+    for line in text[start.end():].splitlines()[1:]:
+        match = RECENT.match(line.strip())
+        if match:
+            recent[int(match.group(1))] = bytes(
+                int(byte, 16) for byte in match.group(2).split())
+            if 2 == len(recent):
+                break
+            continue
+        for name, value in REGISTER.findall(line):
+            if name in REGISTERS:
+                registers[name] = int(value, 16)
+
+    return exception, count, cycles, registers, recent
+
+
+def Faults(value, bits):
+    return [text for bit, text in bits if value & (1 << bit)]
+
+
+def Lookup(addr2line, image, address):
+    """The function and line of `address' in `image'."""
+    try:
+        output = subprocess.run(
+            [addr2line, '-f', '-p', '-C', '-e', image, f'0x{address:x}'],
+            capture_output=True, text=True, check=True).stdout
+    except (OSError, subprocess.CalledProcessError) as error:
+        return f'({error})'
+    return output.strip()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Decode a SerialBridge crash record.')
+    parser.add_argument('capture', nargs='?', default='-',
+                        help='what the host received (default stdin)')
+    parser.add_argument('-e', '--image',
+                        help='the SerialBridge.axf that crashed')
+    parser.add_argument('--addr2line', default='arm-none-eabi-addr2line')
+    args = parser.parse_args()
+
+    if '-' == args.capture:
+        text = sys.stdin.read()
+    else:
+        with open(args.capture, errors='replace') as capture:
+            text = capture.read()
+    record = ParseRecord(text)
+    if record is None:
+        sys.exit(f'{args.capture}: no crash record')
+    exception, count, cycles, registers, recent = record
+    missing = [name for name in REGISTERS if name not in registers]
+    if missing:
+        sys.exit(f'{args.capture}: record cut short, no {", ".join(missing)}')
+
+    print(f'{EXCEPTIONS.get(exception, f"exception {exception}")},'
+          f' crash {count} since power-up, {cycles} cycles after reset')
+    for row in range(0, len(REGISTERS), 4):
+        print(' '.join(f'{name:>10s} {registers[name]:08x}'
+                       for name in REGISTERS[row:row + 4]))
+
+    cfsr = registers['cfsr']
+    hfsr = registers['hfsr']
+    faults = Faults(hfsr, HFSR_BITS) + Faults(cfsr, CFSR_BITS)
+    if cfsr & MMARVALID:
+        faults.append(f'mmfar holds the address: 0x{registers["mmfar"]:08x}')
+    if cfsr & BFARVALID:
+        faults.append(f'bfar holds the address: 0x{registers["bfar"]:08x}')
+    print('\nfaults:')
+    for fault in faults or ['none recorded']:
+        print(f'  {fault}')
+    if not registers['exc_return'] & 0x10:
+        print('  (the FPU state was stacked too)')
+
+    if args.image:
+        print('\ncode:')
+        for name in ('pc', 'lr'):
+            # The stacked lr has the Thumb bit set.
+            address = registers[name] & ~1
+            print(f'  {name} {Lookup(args.addr2line, args.image, address)}')
+
+    print('\nlast chars sent:')
+    for port in (0, 1):
+        print(f'  uart{port}: {ascii(recent.get(port, b""))[1:]}')
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
+
+###############################################################################
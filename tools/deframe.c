@@ -0,0 +1,182 @@
+/******************************************************************************
+ * NAME:	    deframe.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Host end of the framed link of a SerialBridge built with
+ *                  CONFIG_UART_FRAMED=1 (see src/frame.h for the format).
+ *
+ *                    deframe [file]     Check and unwrap frames from the
+ *                                       bridge (default stdin) and write the
+ *                                       payloads to stdout. Bad frames are
+ *                                       reported on stderr and dropped.
+ *                    deframe -e [file]  Wrap the input in frames for the
+ *                                       bridge, one per read.
+ *
+ *                  For example, with the tty in raw mode:
+ *
+ *                    tools/deframe < /dev/ttyACM0
+ *                    tools/deframe -e > /dev/ttyACM0
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "frame.h"
+
+/******************************************************************************
+ * FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        Crc32
+ *
+ * DESCRIPTION:     Bitwise CRC-32 (reflected, polynomial 0x04c11db7). Slow,
+ *                  but independent of the firmware's table-driven version.
+ ***/
+static uint32_t Crc32(const uint8_t* data, size_t length)
+{
+  uint32_t crc = 0xffffffff;
+  for (size_t i = 0; i < length; ++i) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
+    }
+  }
+
+  return crc ^ 0xffffffff;
+}
+
+/******************************************************************************
+ * FUNCTION:        Stuff
+ *
+ * DESCRIPTION:     Write one byte of a frame body, escaped if necessary.
+ ***/
+static void Stuff(uint8_t c, FILE* output)
+{
+  if (FRAME_FLAG == c || FRAME_ESCAPE == c) {
+    putc(FRAME_ESCAPE, output);
+    c ^= FRAME_XOR;
+  }
+
+  putc(c, output);
+}
+
+/******************************************************************************
+ * FUNCTION:        Encode
+ *
+ * DESCRIPTION:     Send everything read from `input' as frames.
+ ***/
+static int Encode(int input, FILE* output)
+{
+  uint8_t payload[FRAME_MAX_PAYLOAD];
+  ssize_t length = 0;
+
+  while (0 < (length = read(input, payload, sizeof(payload)))) {
+    uint32_t crc = Crc32(payload, length);
+    putc(FRAME_FLAG, output);
+    for (ssize_t i = 0; i < length; ++i) {
+      Stuff(payload[i], output);
+    }
+    for (int i = 0; i < FRAME_CRC_SIZE; ++i) {
+      Stuff((uint8_t)(crc >> (8 * i)), output);
+    }
+    putc(FRAME_FLAG, output);
+    fflush(output);
+  }
+
+  return 0 == length ? 0 : 1;
+}
+
+/******************************************************************************
+ * FUNCTION:        Decode
+ *
+ * DESCRIPTION:     Write the payload of every good frame read from `input'.
+ ***/
+static int Decode(int input, FILE* output)
+{
+  static uint8_t frame[FRAME_MAX_PAYLOAD + FRAME_CRC_SIZE];
+  uint8_t chunk[512];
+  size_t length = 0;
+  bool escaped = false;
+  bool overlong = true;
+  unsigned long good = 0;
+  unsigned long bad = 0;
+  ssize_t count = 0;
+
+  while (0 < (count = read(input, chunk, sizeof(chunk)))) {
+    for (ssize_t i = 0; i < count; ++i) {
+      uint8_t c = chunk[i];
+      if (FRAME_FLAG == c) {
+        if (!overlong && length > FRAME_CRC_SIZE) {
+          size_t size = length - FRAME_CRC_SIZE;
+          uint32_t crc = frame[size] | (frame[size + 1] << 8)
+            | (frame[size + 2] << 16) | ((uint32_t)frame[size + 3] << 24);
+          if (crc == Crc32(frame, size)) {
+            fwrite(frame, 1, size, output);
+            good++;
+          } else {
+            fprintf(stderr, "deframe: bad CRC in frame of %zu bytes "
+              "(%lu good, %lu bad)\n", size, good, ++bad);
+          }
+        } else if (!overlong && 0 < length) {
+          fprintf(stderr, "deframe: runt frame (%lu good, %lu bad)\n", good,
+            ++bad);
+        }
+
+        length = 0;
+        escaped = false;
+        overlong = false;
+      } else if (overlong) {
+        continue;
+      } else if (FRAME_ESCAPE == c) {
+        escaped = true;
+      } else if (length == sizeof(frame)) {
+        fprintf(stderr, "deframe: overlong frame (%lu good, %lu bad)\n", good,
+          ++bad);
+        overlong = true;
+      } else {
+        frame[length++] = escaped ? c ^ FRAME_XOR : c;
+        escaped = false;
+      }
+    }
+    fflush(output);
+  }
+
+  return 0 == count ? 0 : 1;
+}
+
+/******************************************************************************
+ * MAIN
+ ***/
+
+int main(int argc, char** argv)
+{
+  bool encode = 1 < argc && 0 == strcmp(argv[1], "-e");
+  int arg = encode ? 2 : 1;
+  if (argc > arg + 1) {
+    fprintf(stderr, "Usage: %s [-e] [file]\n", argv[0]);
+    return 1;
+  }
+
+  int input = STDIN_FILENO;
+  if (argc == arg + 1 && NULL == freopen(argv[arg], "rb", stdin)) {
+    perror(argv[arg]);
+    return 1;
+  }
+
+  return encode ? Encode(input, stdout) : Decode(input, stdout);
+}
+
+/*****************************************************************************/
@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+###############################################################################
+# NAME:		    markers.py
+#
+# AUTHOR:	    Ethan D. Twardy
+#
+# DESCRIPTION:	    Analysis of a logic analyser capture of a SerialBridge
+#                   built with CONFIG_UART_MARKERS=1 (see src/markers.h for
+#                   the pins). Prints the distributions of
+#
+#                     - RX to interrupt: from the moment each UART had the
+#                       last char before an interrupt (the middle of its stop
+#                       bit, when the UART samples it) to the rising edge of
+#                       the interrupt's marker. Interrupts raised by the RX
+#                       timeout (32 bit times after the last char) are shown
+#                       apart from those raised by the FIFO level, and
+#                       interrupts with no new char before them (TX) are left
+#                       out.
+#                     - Durations: how long each marker stays high.
+#
+#                   The capture is a CSV file with a header row: time in
+#                   seconds in the first column, then one 0/1 column per
+#                   channel, either for every sample or only where something
+#                   changed (as sigrok-cli and most analyser software export
+#                   it). Lines starting with ';' or '#' are skipped. Channels
+#                   are found by their column names, which default to the pin
+#                   names:
+#
+#                     tools/markers.py -b 1500000 capture.csv
+#                     tools/markers.py --pair D2:D0 --pair D3:D1 \
+#                         --durations D2,D3,D4,D5 capture.csv
+#
+#                   --pair ISR:RX names the marker of a UART's interrupt and
+#                   its RX line (default PE2:PA0 and PE3:PB0).
+#
+# CREATED:	    10/19/2026
+#
+# LAST EDITED:	    10/19/2026
+###
+
+import argparse
+import bisect
+import csv
+import sys
+
+# The RX timeout fires 32 bit times after the last char. Anything later than
+# this after a char was raised by the timeout.
+TIMEOUT_BITS = 20
+
+
+def ReadCapture(path):
+    """Read the capture into a list of times and a dict of column name to
+    list of levels."""
+    times = []
+    columns = {}
+    with open(path, newline='') as capture:
+        rows = (line for line in capture
+                if line.strip() and line[0] not in ';#')
+        reader = csv.reader(rows)
+        header = [name.strip() for name in next(reader)]
+        names = header[1:]
+        for name in names:
+            columns[name] = []
+        for row in reader:
+            times.append(float(row[0]))
+            for name, value in zip(names, row[1:]):
+                columns[name].append(int(float(value)) != 0)
+
+    return times, columns
+
+
+def Edges(times, levels):
+    """Times of the rising and falling edges of a channel."""
+    rising = []
+    falling = []
+    for i in range(1, len(levels)):
+        if levels[i] and not levels[i - 1]:
+            rising.append(times[i])
+        elif levels[i - 1] and not levels[i]:
+            falling.append(times[i])
+
+    return rising, falling
+
+
+def CharTimes(times, levels, baud):
+    """Times at which the UART had each char on an RX line: the middle of
+    its stop bit, 9.5 bit times after the falling edge of its start bit."""
+    bit = 1.0 / baud
+    chars = []
+    busyUntil = float('-inf')
+    _, falling = Edges(times, levels)
+    for edge in falling:
+        if edge >= busyUntil:
+            chars.append(edge + 9.5 * bit)
+            busyUntil = edge + 9.5 * bit
+    return chars
+
+
+def Summarize(name, values, unit=1e-6):
+    """Print the distribution of `values' (in seconds) in microseconds."""
+    if not values:
+        print(f'{name:36s} (none)')
+        return
+
+    values = sorted(values)
+
+    def At(fraction):
+        return values[min(len(values) - 1, int(fraction * len(values)))]
+
+    print(f'{name:36s} n={len(values):<8d} min={values[0] / unit:9.3f}'
+          f' p50={At(0.5) / unit:9.3f} p90={At(0.9) / unit:9.3f}'
+          f' p99={At(0.99) / unit:9.3f} max={values[-1] / unit:9.3f} us')
+
+
+def RxToIsr(times, columns, isr, rx, baud):
+    """Latency from the last char on `rx' to each rising edge of `isr',
+    split into FIFO-level and RX-timeout interrupts."""
+    chars = CharTimes(times, columns[rx], baud)
+    entries, _ = Edges(times, columns[isr])
+    level = []
+    timeout = []
+    previous = float('-inf')
+    for entry in entries:
+        index = bisect.bisect_right(chars, entry) - 1
+        if index < 0 or chars[index] <= previous:
+            # No new char since the last interrupt: not an RX interrupt.
+            previous = entry
+            continue
+
+        latency = entry - chars[index]
+        if latency > TIMEOUT_BITS / baud:
+            timeout.append(latency)
+        else:
+            level.append(latency)
+        previous = entry
+
+    Summarize(f'{rx} -> {isr} (FIFO level)', level)
+    Summarize(f'{rx} -> {isr} (RX timeout)', timeout)
+
+
+def Durations(times, columns, name):
+    """How long each high pulse of a channel lasts."""
+    rising, falling = Edges(times, columns[name])
+    widths = []
+    for start in rising:
+        index = bisect.bisect_right(falling, start)
+        if index < len(falling):
+            widths.append(falling[index] - start)
+    Summarize(f'{name} high', widths)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='RX-to-interrupt latency and marker durations from a'
+        ' logic analyser capture.')
+    parser.add_argument('capture', help='CSV export of the capture')
+    parser.add_argument('-b', '--baud', type=float, default=1500000,
+                        help='baud rate of the UARTs (default 1500000)')
+    parser.add_argument('--pair', action='append', metavar='ISR:RX',
+                        help='marker of a UART interrupt and its RX line')
+    parser.add_argument('--durations', default='PE2,PE3,PE4,PE5',
+                        help='markers to measure the durations of')
+    args = parser.parse_args()
+
+    times, columns = ReadCapture(args.capture)
+    pairs = [pair.split(':') for pair in (args.pair or ['PE2:PA0',
+                                                        'PE3:PB0'])]
+    durations = [name for name in args.durations.split(',') if name]
+    for name in [name for pair in pairs for name in pair] + durations:
+        if name not in columns:
+            sys.exit(f'{args.capture}: no column named {name}')
+
+    print(f'{len(times)} rows, {times[-1] - times[0]:.6f} s')
+    for isr, rx in pairs:
+        RxToIsr(times, columns, isr, rx, args.baud)
+    for name in durations:
+        Durations(times, columns, name)
+
+
+if __name__ == '__main__':
+    main()
+
+###############################################################################
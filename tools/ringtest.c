@@ -0,0 +1,275 @@
+/******************************************************************************
+ * NAME:	    ringtest.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Host test and benchmark of the ring buffer in
+ *                  src/ringbuf.h. Checks push and pop across the wrap of the
+ *                  indices and of the storage, the span calls, and partial
+ *                  bulk copies into a full ring and out of an empty one, then
+ *                  compares the throughput of RingPushBulk/RingPopBulk with
+ *                  RingPush/RingPop for a few chunk sizes. Exits non-zero on
+ *                  the first failed check. A host CPU is not a Cortex-M4, so
+ *                  only the ratios carry over.
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ringbuf.h"
+
+// Size of the ring under test.
+#define TEST_SIZE 16
+
+// Bytes moved per measurement, and the size of the ring they go through.
+#define BENCH_TOTAL (16u << 20)
+#define BENCH_SIZE 1024
+
+// Fail with the line number if `condition' doesn't hold.
+#define CHECK(condition)                                                \
+  do {                                                                  \
+    if (!(condition)) {                                                 \
+      fprintf(stderr, "ringtest:%d: check failed: %s\n", __LINE__,      \
+        #condition);                                                    \
+      exit(1);                                                          \
+    }                                                                   \
+  } while (0)
+
+RING_STORAGE(g_testStorage, TEST_SIZE);
+RING_STORAGE(g_benchStorage, BENCH_SIZE);
+static uint8_t g_data[BENCH_SIZE];
+
+/******************************************************************************
+ * FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        Now
+ *
+ * DESCRIPTION:     Monotonic time, in seconds.
+ ***/
+static double Now(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/******************************************************************************
+ * FUNCTION:        TestIndexWrap
+ *
+ * DESCRIPTION:     Push and pop with the free-running indices about to wrap
+ *                  past 2^32, so that `head' wraps while `tail' hasn't.
+ ***/
+static void TestIndexWrap(void)
+{
+  ringbuf_t ring;
+  uint8_t c = 0;
+
+  RingInit(&ring, g_testStorage, TEST_SIZE);
+  ring.head = ring.tail = UINT32_MAX - 5;
+  for (uint32_t i = 0; i < TEST_SIZE; ++i) {
+    CHECK(RingPush(&ring, (uint8_t)i));
+    CHECK(i + 1 == RingCount(&ring));
+    CHECK(TEST_SIZE - i - 1 == RingSpace(&ring));
+  }
+
+  CHECK(ring.head < ring.tail);
+  CHECK(!RingPush(&ring, 0xff));
+  for (uint32_t i = 0; i < TEST_SIZE; ++i) {
+    CHECK(RingPop(&ring, &c));
+    CHECK((uint8_t)i == c);
+  }
+
+  CHECK(0 == RingCount(&ring));
+  CHECK(!RingPop(&ring, &c));
+}
+
+/******************************************************************************
+ * FUNCTION:        TestSpans
+ *
+ * DESCRIPTION:     RingWriteSpan and RingReadSpan stop at the end of the
+ *                  storage and pick up again at its start, and RingPeekSpan
+ *                  looks past the first queued byte without consuming it.
+ ***/
+static void TestSpans(void)
+{
+  ringbuf_t ring;
+  uint8_t* write = NULL;
+  const uint8_t* read = NULL;
+
+  // Start 4 bytes short of the end of the storage.
+  RingInit(&ring, g_testStorage, TEST_SIZE);
+  ring.head = ring.tail = TEST_SIZE - 4;
+
+  CHECK(4 == RingWriteSpan(&ring, &write));
+  CHECK(&g_testStorage[TEST_SIZE - 4] == write);
+  for (uint32_t i = 0; i < 4; ++i) {
+    write[i] = (uint8_t)i;
+  }
+  RingWriteCommit(&ring, 4);
+
+  // The rest of the free space is at the start, less what's queued.
+  CHECK(TEST_SIZE - 4 == RingWriteSpan(&ring, &write));
+  CHECK(g_testStorage == write);
+  for (uint32_t i = 0; i < 6; ++i) {
+    write[i] = (uint8_t)(4 + i);
+  }
+  RingWriteCommit(&ring, 6);
+  CHECK(10 == RingCount(&ring));
+
+  // Reads split at the same place.
+  CHECK(4 == RingReadSpan(&ring, &read));
+  CHECK(&g_testStorage[TEST_SIZE - 4] == read && 0 == read[0]);
+
+  // A peek that starts before the end stops there, and one past it starts
+  // from the beginning of the storage.
+  CHECK(2 == RingPeekSpan(&ring, 2, &read));
+  CHECK(2 == read[0] && 3 == read[1]);
+  CHECK(6 == RingPeekSpan(&ring, 4, &read));
+  CHECK(g_testStorage == read && 4 == read[0]);
+  CHECK(1 == RingPeekSpan(&ring, 9, &read) && 9 == read[0]);
+  CHECK(0 == RingPeekSpan(&ring, 10, &read));
+  CHECK(10 == RingCount(&ring));
+
+  RingReadCommit(&ring, 4);
+  CHECK(6 == RingReadSpan(&ring, &read));
+  CHECK(g_testStorage == read && 4 == read[0]);
+  RingReadCommit(&ring, 6);
+  CHECK(0 == RingCount(&ring));
+  CHECK(0 == RingReadSpan(&ring, &read));
+
+  // A full ring has no free span.
+  for (uint32_t i = 0; i < TEST_SIZE; ++i) {
+    CHECK(RingPush(&ring, (uint8_t)i));
+  }
+  CHECK(0 == RingWriteSpan(&ring, &write));
+}
+
+/******************************************************************************
+ * FUNCTION:        TestBulk
+ *
+ * DESCRIPTION:     RingPushBulk and RingPopBulk copy across the end of the
+ *                  storage, and copy only what fits into a full ring or is
+ *                  left in an empty one.
+ ***/
+static void TestBulk(void)
+{
+  ringbuf_t ring;
+  uint8_t in[2 * TEST_SIZE];
+  uint8_t out[2 * TEST_SIZE];
+
+  for (uint32_t i = 0; i < sizeof(in); ++i) {
+    in[i] = (uint8_t)(0x40 + i);
+  }
+
+  for (uint32_t start = 0; start < TEST_SIZE; ++start) {
+    RingInit(&ring, g_testStorage, TEST_SIZE);
+    ring.head = ring.tail = start;
+
+    // More than fits: only the space is taken, in two spans at most.
+    CHECK(TEST_SIZE == RingPushBulk(&ring, in, sizeof(in)));
+    CHECK(0 == RingSpace(&ring));
+    CHECK(0 == RingPushBulk(&ring, in, 1));
+
+    // Less than is queued, then more than is left.
+    CHECK(5 == RingPopBulk(&ring, out, 5));
+    CHECK(0 == memcmp(in, out, 5));
+    CHECK(TEST_SIZE - 5 == RingPopBulk(&ring, out + 5, sizeof(out) - 5));
+    CHECK(0 == memcmp(in, out, TEST_SIZE));
+    CHECK(0 == RingPopBulk(&ring, out, 1));
+
+    // Partly full: the push stops where the earlier bytes are.
+    CHECK(3 == RingPushBulk(&ring, in, 3));
+    CHECK(TEST_SIZE - 3 == RingPushBulk(&ring, in + 3, TEST_SIZE));
+    CHECK(TEST_SIZE == RingPopBulk(&ring, out, sizeof(out)));
+    CHECK(0 == memcmp(in, out, TEST_SIZE));
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:        BenchBytes
+ *
+ * DESCRIPTION:     Throughput of RingPush/RingPop, moving `chunk' bytes at a
+ *                  time through the ring, in MB/s.
+ ***/
+static double BenchBytes(ringbuf_t* ring, uint32_t chunk,
+  volatile uint32_t* sink)
+{
+  uint8_t c = 0;
+  double start = Now();
+  for (uint32_t done = 0; done < BENCH_TOTAL; done += chunk) {
+    for (uint32_t i = 0; i < chunk; ++i) {
+      RingPush(ring, g_data[i]);
+    }
+    for (uint32_t i = 0; i < chunk; ++i) {
+      RingPop(ring, &c);
+      *sink ^= c;
+    }
+  }
+  return BENCH_TOTAL / (Now() - start) / 1e6;
+}
+
+/******************************************************************************
+ * FUNCTION:        BenchBulk
+ *
+ * DESCRIPTION:     Throughput of RingPushBulk/RingPopBulk, moving `chunk'
+ *                  bytes at a time through the ring, in MB/s.
+ ***/
+static double BenchBulk(ringbuf_t* ring, uint32_t chunk,
+  volatile uint32_t* sink)
+{
+  static uint8_t out[BENCH_SIZE];
+  double start = Now();
+  for (uint32_t done = 0; done < BENCH_TOTAL; done += chunk) {
+    RingPushBulk(ring, g_data, chunk);
+    RingPopBulk(ring, out, chunk);
+    *sink ^= out[chunk - 1];
+  }
+  return BENCH_TOTAL / (Now() - start) / 1e6;
+}
+
+/******************************************************************************
+ * MAIN
+ ***/
+
+int main(void)
+{
+  // 16 is the depth of the UART FIFOs, which is what the top halves move.
+  static const uint32_t chunks[] = { 1, 16, 64, 256 };
+  volatile uint32_t sink = 0;
+  ringbuf_t ring;
+
+  TestIndexWrap();
+  TestSpans();
+  TestBulk();
+  printf("ringtest: all checks passed\n\n");
+
+  srand(1);
+  for (uint32_t i = 0; i < sizeof(g_data); ++i) {
+    g_data[i] = (uint8_t)rand();
+  }
+
+  // Start off the alignment of the storage, so that chunks straddle its end.
+  RingInit(&ring, g_benchStorage, BENCH_SIZE);
+  ring.head = ring.tail = BENCH_SIZE - 3;
+  printf("%8s %14s %14s\n", "chunk", "RingPush/Pop", "Bulk");
+  for (uint32_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); ++i) {
+    printf("%8u %9.0f MB/s %9.0f MB/s\n", chunks[i],
+      BenchBytes(&ring, chunks[i], &sink), BenchBulk(&ring, chunks[i], &sink));
+  }
+
+  return 0;
+}
+
+/*****************************************************************************/
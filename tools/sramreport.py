@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+###############################################################################
+# NAME:		    sramreport.py
+#
+# AUTHOR:	    Ethan D. Twardy
+#
+# DESCRIPTION:	    SRAM usage of a SerialBridge build, from the map file the
+#                   linker writes next to it (SerialBridge.map). Prints how
+#                   much of each SRAM budget in src/SerialBridge.ld is used,
+#                   then the largest variables in each part:
+#
+#                     tools/sramreport.py [-n count] SerialBridge.map
+#
+#                   The link already fails when a budget is exceeded; this
+#                   shows how much room is left. The stack line is the size
+#                   reserved for it (CONFIG_STACK_SIZE). How much of that is
+#                   actually used is only known at run time, from
+#                   StackHighWater(). `make sram' links and runs this.
+#
+# CREATED:	    10/19/2026
+#
+# LAST EDITED:	    10/19/2026
+###
+
+import argparse
+import re
+import sys
+
+SRAM_START = 0x20000000
+SRAM_SIZE = 0x8000
+
+# The parts of SRAM, and the linker symbols around them.
+PARTS = [
+    ('vtable', '_vtable', '_evtable'),
+    ('data', '_data', '_edata'),
+    ('bss', '_bss', '_ebss'),
+    ('buffers', '_buffers', '_ebuffers'),
+    ('stack', '_stack', '_estack'),
+    ('noinit', '_noinit', '_enoinit'),
+]
+
+ASSIGNMENT = re.compile(r'^\s+0x([0-9a-f]+)\s+(\w+) = ')
+SECTION = re.compile(r'^ (\S+)?\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)(?:\s+(\S+))?$')
+SYMBOL = re.compile(r'^\s+0x([0-9a-f]+)\s+([A-Za-z_][\w.]*)$')
+
+
+def ReadMap(path):
+    """The symbols the linker script assigns, and the variables in SRAM as
+    (address, size, name, object) tuples."""
+    assigned = {}
+    variables = []
+    section = None
+    pending = None
+    with open(path) as mapFile:
+        lines = iter(mapFile)
+        for line in lines:
+            if line.startswith('Linker script and memory map'):
+                break
+        for line in lines:
+            line = line.rstrip('\n')
+            match = ASSIGNMENT.match(line)
+            if match:
+                assigned[match.group(2)] = int(match.group(1), 16)
+                continue
+
+            # An input section's name is on a line of its own when it's long.
+            if re.match(r'^ \S+$', line) and not line.startswith(' *'):
+                pending = line.strip()
+                continue
+
+            match = SECTION.match(line)
+            if match and (match.group(1) or pending) and match.group(4):
+                address = int(match.group(2), 16)
+                size = int(match.group(3), 16)
+                section = (address, size, match.group(1) or pending,
+                           match.group(4), [])
+                if SRAM_START <= address < SRAM_START + SRAM_SIZE and size:
+                    variables.append(section)
+                pending = None
+                continue
+            pending = None
+
+            match = SYMBOL.match(line)
+            if match and section:
+                section[4].append((int(match.group(1), 16), match.group(2)))
+
+    # Each symbol runs until the next one in its section, or the section's
+    # end. The map only lists global symbols, so a static is named after its
+    # section, which -fdata-sections (or SRAM_BUFFER()) names after it.
+    sized = []
+    for address, size, name, obj, symbols in variables:
+        if not symbols:
+            name = re.sub(r'^\.(bss\.buffers|bss|data|stack|noinit)\.', '',
+                          name)
+            sized.append((address, size, name, obj))
+            continue
+        symbols.sort()
+        ends = [symbol[0] for symbol in symbols[1:]] + [address + size]
+        for (start, name), end in zip(symbols, ends):
+            sized.append((start, end - start, name, obj))
+
+    return assigned, sized
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='SRAM usage against the budgets in the linker script.')
+    parser.add_argument('map', help='map file written by the linker')
+    parser.add_argument('-n', '--count', type=int, default=5,
+                        help='largest variables to list in each part')
+    args = parser.parse_args()
+
+    assigned, variables = ReadMap(args.map)
+    for _, start, end in PARTS:
+        for symbol in (start, end):
+            if symbol not in assigned:
+                sys.exit(f'{args.map}: no {symbol}; is it from this'
+                         ' project\'s linker script?')
+
+    ranges = {name: (assigned[start], assigned[end])
+              for name, start, end in PARTS}
+    sizes = {name: end - start for name, (start, end) in ranges.items()}
+    # vtable and buffers are carved out of .data and .bss.
+    sizes['data'] -= sizes['vtable']
+    sizes['bss'] -= sizes['buffers']
+
+    print(f'{"part":10s} {"used":>8s} {"budget":>8s} {"of budget":>10s}')
+    over = False
+    for name, _, _ in PARTS:
+        budget = assigned.get('_budget_' + name, 0)
+        used = sizes[name]
+        over |= used > budget
+        print(f'{name:10s} {used:8d} {budget:8d}'
+              f' {100.0 * used / budget if budget else 0:9.1f}%'
+              + ('  OVER' if used > budget else ''))
+
+    # No-init is at the very end of SRAM, so what's free is the gap before
+    # it.
+    end = ranges['stack'][1]
+    total = end - SRAM_START + sizes['noinit']
+    print(f'{"total":10s} {total:8d} {SRAM_SIZE:8d}'
+          f' {100.0 * total / SRAM_SIZE:9.1f}%'
+          f'  ({ranges["noinit"][0] - end} bytes free,'
+          f' {sum(sizes.values())} bytes allocated)')
+
+    # The parts nest (vtable in data, buffers in bss), so the innermost one
+    # that holds a variable is the one it's listed under.
+    listed = {name: [] for name, _, _ in PARTS}
+    for variable in variables:
+        for name in ('vtable', 'buffers', 'data', 'bss', 'stack', 'noinit'):
+            start, end = ranges[name]
+            if start <= variable[0] < end:
+                listed[name].append(variable)
+                break
+
+    for name, _, _ in PARTS:
+        largest = sorted(listed[name], key=lambda v: -v[1])[:args.count]
+        if not largest:
+            continue
+        print(f'\n{name}:')
+        for address, size, symbol, obj in largest:
+            print(f'  0x{address:08x} {size:8d}  {symbol} ({obj})')
+
+    return 1 if over else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
+
+###############################################################################
@@ -0,0 +1,379 @@
+/******************************************************************************
+ * NAME:	    swodecode.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Decoder for the SWO trace of a SerialBridge built with
+ *                  CONFIG_UART_TRACE=1 (see src/trace.h for the events).
+ *
+ *                    swodecode [-c hz] [-p source] [file]
+ *                        One line per event, with its time since the start
+ *                        of the capture, its source and what happened. For
+ *                        an interrupt exit, the time since its entry is
+ *                        shown. -p shows the timeline of one source only
+ *                        (uart0, uart1, tap or bottom).
+ *
+ *                    swodecode -s [-c hz] [file]
+ *                        Only the totals for each source: interrupts, time
+ *                        spent in them, chars moved, and FIFO-full, drop and
+ *                        overrun events.
+ *
+ *                  The input (default stdin) is the raw SWO byte stream,
+ *                  captured from the start of the trace. -c gives the system
+ *                  clock of the bridge (default 80 MHz), which the ITM
+ *                  timestamps count. Durations of the bottom half include
+ *                  any top halves that preempted it.
+ *
+ *                  For example, with a USB serial adapter on PC3:
+ *
+ *                    stty -F /dev/ttyUSB1 raw 8000000
+ *                    cat /dev/ttyUSB1 > trace.swo
+ *                    tools/swodecode -p uart1 trace.swo
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "trace.h"
+
+#define SOURCES             4
+// Events are held until the timestamp that follows them arrives.
+#define MAX_PENDING         64
+
+// ITM packet headers.
+#define ITM_SYNC_ZEROS      5
+#define ITM_SYNC_END        0x80
+#define ITM_OVERFLOW        0x70
+#define ITM_GTS1            0x94
+#define ITM_GTS2            0xb4
+
+typedef struct {
+
+  uint8_t port;
+  uint32_t value;
+
+} event_t;
+
+typedef struct {
+
+  bool inside;
+  uint64_t enteredAt;
+  uint64_t interrupts;
+  uint64_t cycles;
+  uint64_t maxCycles;
+  uint64_t rx;
+  uint64_t tx;
+  uint64_t forwarded;
+  uint64_t fifoFull;
+  uint64_t drops;
+  uint64_t overruns;
+
+} source_t;
+
+typedef struct {
+
+  double hz;
+  bool summary;
+  int only;
+  uint64_t now;
+  event_t pending[MAX_PENDING];
+  uint32_t pendingCount;
+  source_t sources[SOURCES];
+  uint64_t modeChanges;
+  uint64_t events;
+  uint64_t overflows;
+  uint64_t syncs;
+  uint64_t unknown;
+
+} decoder_t;
+
+static const char* const sourceNames[SOURCES] = {
+  "uart0", "uart1", "tap", "bottom",
+};
+
+static const char* const modeNames[] = {
+  "interrupt", "poll", "bert", "bench",
+};
+
+/******************************************************************************
+ * FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        ApplyEvent
+ *
+ * DESCRIPTION:     Account for one event at the decoder's current time, and
+ *                  print it.
+ ***/
+static void ApplyEvent(decoder_t* decoder, const event_t* event)
+{
+  const bool counted = TRACE_PORT_RX == event->port
+    || TRACE_PORT_TX == event->port || TRACE_PORT_FORWARD == event->port;
+  const uint32_t source = counted ? event->value >> 24 : event->value;
+  const uint32_t count = event->value & 0xffffff;
+  char detail[64] = "";
+
+  decoder->events++;
+  if (TRACE_PORT_MODE == event->port) {
+    decoder->modeChanges++;
+    if (!decoder->summary && decoder->only < 0) {
+      printf("%16.9f %-6s mode %s\n", decoder->now / decoder->hz, "-",
+        source < sizeof(modeNames) / sizeof(*modeNames) ? modeNames[source]
+        : "?");
+    }
+    return;
+  }
+
+  if (source >= SOURCES) {
+    decoder->unknown++;
+    return;
+  }
+
+  source_t* s = &decoder->sources[source];
+  switch (event->port) {
+  case TRACE_PORT_ENTER:
+    s->inside = true;
+    s->enteredAt = decoder->now;
+    s->interrupts++;
+    strcpy(detail, "enter");
+    break;
+  case TRACE_PORT_EXIT:
+    if (s->inside) {
+      const uint64_t cycles = decoder->now - s->enteredAt;
+      s->cycles += cycles;
+      if (cycles > s->maxCycles) {
+        s->maxCycles = cycles;
+      }
+      snprintf(detail, sizeof(detail), "exit after %llu cycles",
+        (unsigned long long)cycles);
+    } else {
+      strcpy(detail, "exit");
+    }
+    s->inside = false;
+    break;
+  case TRACE_PORT_RX:
+    s->rx += count;
+    snprintf(detail, sizeof(detail), "rx %u", count);
+    break;
+  case TRACE_PORT_TX:
+    s->tx += count;
+    snprintf(detail, sizeof(detail), "tx %u", count);
+    break;
+  case TRACE_PORT_FORWARD:
+    s->forwarded += count;
+    snprintf(detail, sizeof(detail), "forward %u", count);
+    break;
+  case TRACE_PORT_FIFO_FULL:
+    s->fifoFull++;
+    strcpy(detail, "tx fifo full");
+    break;
+  case TRACE_PORT_DROP:
+    s->drops++;
+    strcpy(detail, "drop");
+    break;
+  case TRACE_PORT_OVERRUN:
+    s->overruns++;
+    strcpy(detail, "overrun");
+    break;
+  default:
+    decoder->unknown++;
+    return;
+  }
+
+  if (!decoder->summary && (decoder->only < 0
+      || (uint32_t)decoder->only == source)) {
+    printf("%16.9f %-6s %s\n", decoder->now / decoder->hz,
+      sourceNames[source], detail);
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:        Flush
+ *
+ * DESCRIPTION:     Apply the events waiting for a timestamp at the current
+ *                  time.
+ ***/
+static void Flush(decoder_t* decoder)
+{
+  for (uint32_t i = 0; i < decoder->pendingCount; ++i) {
+    ApplyEvent(decoder, &decoder->pending[i]);
+  }
+  decoder->pendingCount = 0;
+}
+
+/******************************************************************************
+ * FUNCTION:        ReadContinued
+ *
+ * DESCRIPTION:     Read the bytes of a packet that follow a header with its
+ *                  continuation bit set: 7 bits each, least significant
+ *                  first, until one has the continuation bit clear.
+ *
+ * RETURNS:         The value, or -1 at end of input.
+ ***/
+static int64_t ReadContinued(FILE* input)
+{
+  uint64_t value = 0;
+  int shift = 0;
+  int c = 0;
+
+  do {
+    if (EOF == (c = fgetc(input))) {
+      return -1;
+    }
+    if (shift < 56) {
+      value |= (uint64_t)(c & 0x7f) << shift;
+    }
+    shift += 7;
+  } while (c & 0x80);
+
+  return (int64_t)value;
+}
+
+/******************************************************************************
+ * FUNCTION:        PrintSummary
+ *
+ * DESCRIPTION:     Print the totals for each source.
+ ***/
+static void PrintSummary(const decoder_t* decoder)
+{
+  printf("%-6s %10s %12s %8s %8s %10s %10s %10s %8s %8s %8s\n", "source",
+    "interrupts", "cycles", "mean", "max", "rx", "tx", "forwarded",
+    "fifofull", "drops", "overruns");
+  for (uint32_t i = 0; i < SOURCES; ++i) {
+    const source_t* s = &decoder->sources[i];
+    printf("%-6s %10llu %12llu %8.1f %8llu %10llu %10llu %10llu %8llu %8llu"
+      " %8llu\n", sourceNames[i], (unsigned long long)s->interrupts,
+      (unsigned long long)s->cycles,
+      s->interrupts ? (double)s->cycles / s->interrupts : 0.0,
+      (unsigned long long)s->maxCycles, (unsigned long long)s->rx,
+      (unsigned long long)s->tx, (unsigned long long)s->forwarded,
+      (unsigned long long)s->fifoFull, (unsigned long long)s->drops,
+      (unsigned long long)s->overruns);
+  }
+  printf("%.6f s traced, %llu mode changes\n", decoder->now / decoder->hz,
+    (unsigned long long)decoder->modeChanges);
+}
+
+/******************************************************************************
+ * MAIN
+ ***/
+
+int main(int argc, char** argv)
+{
+  static decoder_t decoder;
+  int opt = 0;
+
+  decoder.hz = 80e6;
+  decoder.only = -1;
+  while (-1 != (opt = getopt(argc, argv, "sc:p:"))) {
+    switch (opt) {
+    case 's': decoder.summary = true; break;
+    case 'c': decoder.hz = atof(optarg); break;
+    case 'p':
+      for (int i = 0; i < SOURCES; ++i) {
+        if (0 == strcmp(optarg, sourceNames[i])) {
+          decoder.only = i;
+        }
+      }
+      if (decoder.only < 0) {
+        fprintf(stderr, "%s: unknown source %s\n", argv[0], optarg);
+        return 1;
+      }
+      break;
+    default:
+      fprintf(stderr, "usage: %s [-s] [-c hz] [-p source] [file]\n",
+        argv[0]);
+      return 1;
+    }
+  }
+
+  FILE* input = stdin;
+  if (optind < argc && NULL == (input = fopen(argv[optind], "rb"))) {
+    perror(argv[optind]);
+    return 1;
+  }
+
+  uint32_t zeros = 0;
+  int c = 0;
+  while (EOF != (c = fgetc(input))) {
+    // Sync: at least five zero bytes, then 0x80.
+    if (0 == c) {
+      zeros++;
+      continue;
+    } else if (0 < zeros) {
+      if (ITM_SYNC_END == c && zeros >= ITM_SYNC_ZEROS) {
+        decoder.syncs++;
+      } else {
+        decoder.unknown++;
+      }
+      zeros = 0;
+      continue;
+    }
+
+    if (ITM_OVERFLOW == c) {
+      decoder.overflows++;
+    } else if (0 == (c & 0x0f)) {
+      // Local timestamp: the cycles since the previous one, which apply to
+      // the events sent since.
+      int64_t delta = (c >> 4) & 0x07;
+      if ((c & 0x80) && (delta = ReadContinued(input)) < 0) {
+        break;
+      }
+      decoder.now += (uint64_t)delta;
+      Flush(&decoder);
+    } else if (ITM_GTS1 == c || ITM_GTS2 == c || 0x08 == (c & 0x0b)) {
+      // Global timestamps and extension packets aren't used.
+      if ((c & 0x80) && ReadContinued(input) < 0) {
+        break;
+      }
+    } else if (0 != (c & 0x03) && 0 == (c & 0x04)) {
+      // Instrumentation packet: the port, then 1, 2 or 4 bytes of payload.
+      const int size = 3 == (c & 0x03) ? 4 : (c & 0x03);
+      uint8_t payload[4] = { 0 };
+      if (1 != fread(payload, (size_t)size, 1, input)) {
+        break;
+      }
+
+      if (MAX_PENDING == decoder.pendingCount) {
+        Flush(&decoder);
+      }
+      event_t* event = &decoder.pending[decoder.pendingCount++];
+      event->port = (uint8_t)(c >> 3);
+      event->value = (uint32_t)payload[0] | ((uint32_t)payload[1] << 8)
+        | ((uint32_t)payload[2] << 16) | ((uint32_t)payload[3] << 24);
+    } else if (0 != (c & 0x03)) {
+      // Hardware source packets (from the DWT) aren't enabled, but skip them.
+      const int size = 3 == (c & 0x03) ? 4 : (c & 0x03);
+      for (int i = 0; i < size; ++i) {
+        fgetc(input);
+      }
+      decoder.unknown++;
+    } else {
+      decoder.unknown++;
+    }
+  }
+  Flush(&decoder);
+
+  if (decoder.summary) {
+    PrintSummary(&decoder);
+  }
+  fprintf(stderr, "%llu events, %llu syncs, %llu ITM overflows, %llu bytes"
+    " not understood\n", (unsigned long long)decoder.events,
+    (unsigned long long)decoder.syncs, (unsigned long long)decoder.overflows,
+    (unsigned long long)decoder.unknown);
+  return 0;
+}
+
+/*****************************************************************************/
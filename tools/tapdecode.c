@@ -0,0 +1,216 @@
+/******************************************************************************
+ * NAME:	    tapdecode.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Decoder for the tap output of a SerialBridge built with
+ *                  CONFIG_UART_TAP=1 (see src/tap.h for the format).
+ *
+ *                    tapdecode [-c hz] [file]     One line per run, with
+ *                                                 its time since boot and
+ *                                                 direction, and the chars
+ *                                                 quoted C-style.
+ *                    tapdecode -p [-c hz] [file]  A pcap capture with
+ *                                                 nanosecond timestamps and
+ *                                                 link type USER0. Each
+ *                                                 packet is a direction byte
+ *                                                 (0: host to target, 1:
+ *                                                 target to host), then the
+ *                                                 run.
+ *
+ *                  The input (default stdin) may be a capture file or the
+ *                  tty itself. -c gives the system clock of the bridge
+ *                  (default 80 MHz), which the timestamps count.
+ *
+ *                  For example, with the tty in raw mode:
+ *
+ *                    tools/tapdecode < /dev/ttyUSB0
+ *                    tools/tapdecode -p < /dev/ttyUSB0 > console.pcap
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "tap.h"
+
+// pcap file format constants.
+#define PCAP_MAGIC_NS       0xa1b23c4d
+#define PCAP_LINKTYPE_USER0 147
+
+typedef struct {
+
+  uint32_t magic;
+  uint16_t versionMajor;
+  uint16_t versionMinor;
+  int32_t thisZone;
+  uint32_t sigFigs;
+  uint32_t snapLength;
+  uint32_t linkType;
+
+} pcap_header_t;
+
+typedef struct {
+
+  uint32_t seconds;
+  uint32_t nanoseconds;
+  uint32_t capturedLength;
+  uint32_t length;
+
+} pcap_record_t;
+
+/******************************************************************************
+ * FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        PrintRun
+ *
+ * DESCRIPTION:     Print one run as text.
+ ***/
+static void PrintRun(uint64_t ticks, double hz, bool fromTarget,
+  const uint8_t* data, uint32_t length)
+{
+  printf("%16.9f %s \"", ticks / hz, fromTarget ? "T>H" : "H>T");
+  for (uint32_t i = 0; i < length; ++i) {
+    switch (data[i]) {
+    case '\r': fputs("\\r", stdout); break;
+    case '\n': fputs("\\n", stdout); break;
+    case '\t': fputs("\\t", stdout); break;
+    case '\\': fputs("\\\\", stdout); break;
+    case '"': fputs("\\\"", stdout); break;
+    default:
+      if (0x20 <= data[i] && data[i] < 0x7f) {
+        putchar(data[i]);
+      } else {
+        printf("\\x%02x", data[i]);
+      }
+      break;
+    }
+  }
+  fputs("\"\n", stdout);
+}
+
+/******************************************************************************
+ * FUNCTION:        WriteRun
+ *
+ * DESCRIPTION:     Write one run as a pcap record.
+ ***/
+static void WriteRun(uint64_t ticks, double hz, bool fromTarget,
+  const uint8_t* data, uint32_t length)
+{
+  const uint64_t nanoseconds = (uint64_t)(ticks / hz * 1e9);
+  const pcap_record_t record = {
+    .seconds = (uint32_t)(nanoseconds / 1000000000),
+    .nanoseconds = (uint32_t)(nanoseconds % 1000000000),
+    .capturedLength = length + 1,
+    .length = length + 1,
+  };
+  const uint8_t direction = fromTarget ? 1 : 0;
+
+  fwrite(&record, sizeof(record), 1, stdout);
+  fwrite(&direction, 1, 1, stdout);
+  fwrite(data, 1, length, stdout);
+}
+
+/******************************************************************************
+ * MAIN
+ ***/
+
+int main(int argc, char** argv)
+{
+  bool pcap = false;
+  double hz = 80e6;
+  int opt = 0;
+
+  while (-1 != (opt = getopt(argc, argv, "pc:"))) {
+    switch (opt) {
+    case 'p': pcap = true; break;
+    case 'c': hz = atof(optarg); break;
+    default:
+      fprintf(stderr, "usage: %s [-p] [-c hz] [file]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  FILE* input = stdin;
+  if (optind < argc && NULL == (input = fopen(argv[optind], "rb"))) {
+    perror(argv[optind]);
+    return 1;
+  }
+
+  if (pcap) {
+    const pcap_header_t header = {
+      .magic = PCAP_MAGIC_NS,
+      .versionMajor = 2,
+      .versionMinor = 4,
+      .snapLength = TAP_MAX_RUN + 1,
+      .linkType = PCAP_LINKTYPE_USER0,
+    };
+    fwrite(&header, sizeof(header), 1, stdout);
+  }
+
+  // Runs are decoded as they arrive, so that a live tty can be followed.
+  setvbuf(stdout, NULL, _IOLBF, 0);
+  uint8_t record[TAP_HEADER_SIZE + TAP_MAX_RUN];
+  uint64_t epoch = 0;
+  uint64_t bytes[2] = { 0 };
+  uint64_t runs = 0;
+  uint64_t skipped = 0;
+  int c = 0;
+
+  while (EOF != (c = fgetc(input))) {
+    // Anything between records means we started mid-record, or lost data.
+    if (TAP_SYNC != c) {
+      skipped++;
+      continue;
+    }
+
+    record[0] = (uint8_t)c;
+    if (1 != fread(record + 1, TAP_HEADER_SIZE - 1, 1, input)) {
+      break;
+    }
+
+    const uint8_t tag = record[1];
+    const uint32_t stamp = (uint32_t)record[2] | ((uint32_t)record[3] << 8)
+      | ((uint32_t)record[4] << 16) | ((uint32_t)record[5] << 24);
+    if (TAP_EPOCH == tag) {
+      epoch = (uint64_t)stamp << 32;
+      continue;
+    }
+
+    const uint32_t length = tag & TAP_MAX_RUN;
+    const bool fromTarget = 0 != (tag & TAP_FROM_TARGET);
+    uint8_t* data = record + TAP_HEADER_SIZE;
+    if (1 != fread(data, length, 1, input)) {
+      break;
+    }
+
+    if (pcap) {
+      WriteRun(epoch | stamp, hz, fromTarget, data, length);
+    } else {
+      PrintRun(epoch | stamp, hz, fromTarget, data, length);
+    }
+    bytes[fromTarget] += length;
+    runs++;
+  }
+
+  fprintf(stderr, "%llu runs, %llu bytes host to target, %llu bytes target"
+    " to host, %llu bytes skipped\n", (unsigned long long)runs,
+    (unsigned long long)bytes[0], (unsigned long long)bytes[1],
+    (unsigned long long)skipped);
+  return 0;
+}
+
+/*****************************************************************************/
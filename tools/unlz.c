@@ -0,0 +1,123 @@
+/******************************************************************************
+ * NAME:	    unlz.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Host-side decompressor for the stream produced by a
+ *                  SerialBridge built with CONFIG_UART_COMPRESS=1. Reads the
+ *                  compressed stream from a file or stdin (e.g. the upstream
+ *                  tty, in raw mode) and writes the original bytes to stdout
+ *                  as soon as they are decoded. The decoder must be started
+ *                  with the stream, i.e. before the board is reset.
+ *
+ *                  Build with `make tools', then e.g.:
+ *
+ *                    stty -F /dev/ttyACM0 raw 1500000
+ *                    tools/unlz < /dev/ttyACM0
+ *
+ * CREATED:	    10/19/2026
+ *
+ * LAST EDITED:	    10/19/2026
+ ***/
+
+/******************************************************************************
+ * PREAMBLE
+ ***/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lz.h"
+
+typedef struct {
+
+  uint8_t window[LZ_WINDOW];
+  uint32_t position;
+  // Bytes of the current token still expected: literals, or the offset of a
+  // match (-1 while waiting for the next token).
+  int literals;
+  int matchLength;
+  uint8_t matchHigh;
+
+} unlz_t;
+
+/******************************************************************************
+ * FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:        Emit
+ *
+ * DESCRIPTION:     Append a decoded byte to the window and the output.
+ ***/
+static void Emit(unlz_t* state, uint8_t c, FILE* output)
+{
+  state->window[state->position++ & (LZ_WINDOW - 1)] = c;
+  putc(c, output);
+}
+
+/******************************************************************************
+ * FUNCTION:        Decode
+ *
+ * DESCRIPTION:     Feed one byte of the compressed stream to the decoder.
+ ***/
+static void Decode(unlz_t* state, uint8_t c, FILE* output)
+{
+  if (0 < state->literals) {
+    state->literals--;
+    Emit(state, c, output);
+    return;
+  }
+
+  if (0 < state->matchLength) {
+    uint32_t distance = (((uint32_t)state->matchHigh << 8) | c) + 1;
+    for (int i = 0; i < state->matchLength; ++i) {
+      Emit(state, state->window[(state->position - distance)
+          & (LZ_WINDOW - 1)], output);
+    }
+    state->matchLength = 0;
+    return;
+  }
+
+  if (c & LZ_MATCH_FLAG) {
+    state->matchLength = ((c >> 2) & 0x1f) + LZ_MIN_MATCH;
+    state->matchHigh = c & 0x3;
+  } else {
+    state->literals = c + 1;
+  }
+}
+
+/******************************************************************************
+ * MAIN
+ ***/
+
+int main(int argc, char** argv)
+{
+  FILE* input = stdin;
+  if (2 == argc) {
+    if (NULL == (input = fopen(argv[1], "rb"))) {
+      perror(argv[1]);
+      return 1;
+    }
+  } else if (2 < argc) {
+    fprintf(stderr, "Usage: %s [compressed-file]\n", argv[0]);
+    return 1;
+  }
+
+  // Unbuffered input, so that each line shows up as soon as it's decoded.
+  setvbuf(input, NULL, _IONBF, 0);
+
+  static unlz_t state;
+  int c = 0;
+  while (EOF != (c = getc(input))) {
+    Decode(&state, (uint8_t)c, stdout);
+    if (0 == state.literals && 0 == state.matchLength) {
+      fflush(stdout);
+    }
+  }
+
+  return 0;
+}
+
+/*****************************************************************************/